@@ -0,0 +1,515 @@
+#include "batch.h"
+#include "calib.h"
+#include "pipeline.h"
+#include "corpus.h"
+#include "fielddesc.h"
+#include "mt.h"
+#include "render.h"
+#include "tiled.h"
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+
+/* Подряд идущих неудачных полей, после которых параметры считаются безнадёжными */
+#define BATCH_MAX_FAILS 10
+
+/* Наибольшая сторона поля в обычном режиме (поле целиком в памяти) */
+#define BATCH_MAX_SIDE (1 << 15)
+
+/* Формат вывода */
+typedef enum {
+    BATCH_TEXT,         /* текст save_field_to_file */
+    BATCH_BIN,          /* двоичный корпус (corpus.h) */
+    BATCH_DESC          /* 32-байтные дескрипторы FieldDesc (fielddesc.h) */
+} BatchFormat;
+
+/* Параметры пакетного запуска */
+typedef struct {
+    int rows, cols;
+    long long tiled_rows; /* --rows как 64-битное число (для потокового режима) */
+    int tile_rows;      /* > 0: потоковая генерация полосами (tiled.h) */
+    int percent;        /* вероятность мины, если mines < 0 */
+    int mines;          /* >= 0: точное число мин */
+    long count;
+    uint64_t seed;
+    int threads;
+    int queue;          /* ёмкость очереди конвейера (0 — по умолчанию) */
+    int attempts;
+    int start_r, start_c;
+    int repair;         /* > 0: генерация с починкой (generate_repair), раундов на поле */
+    SolverStrength strength;
+    const char* out;
+    BatchFormat format;
+    int view_r, view_c, view_h, view_w; /* view_h > 0: вместо поля — его окно (render_viewport) */
+    int overview_rows, overview_cols;   /* > 0: вместо поля — уменьшенный обзор (render_overview) */
+    const char* expand; /* файл дескрипторов: восстановить поля вместо генерации */
+    bool quiet;
+    const char* stats;  /* куда записать статистику в JSON ("-" — stderr), NULL — не нужно */
+    const char* calib;  /* таблица калибровки (calib.h), NULL — без неё */
+} BatchOpts;
+
+static void batch_usage(const char* prog) {
+    fprintf(stderr,
+        "Использование: %s --rows R --cols C (--density P | --mines M) [--count N]\n"
+        "       [--seed S] [--threads T] [--queue Q] [--attempts A] [--start R,C]\n"
+        "       [--strength basic|subset] [--out PATH] [--format text|bin|desc] [--stats PATH] [--calib PATH]\n"
+        "       [--repair ROUNDS] [--tile-rows N] [--view R0,C0,H,W | --overview ROWS,COLS] [--quiet]\n"
+        "       %s --expand DESC_OR_CORPUS_PATH [--out PATH] [--format text|bin]\n"
+        "       [--view R0,C0,H,W | --overview ROWS,COLS] [--quiet]\n", prog, prog);
+}
+
+/* Общая часть batch_long и --rows: на Windows long 32-битный, а высота потокового поля — нет */
+static bool batch_llong(const char* s, long long lo, long long hi, long long* v) {
+    char* end;
+    errno = 0;
+    long long x = strtoll(s, &end, 10);
+    if (end == s || *end != '\0' || errno == ERANGE || x < lo || x > hi) return false;
+    *v = x;
+    return true;
+}
+
+bool batch_long(const char* s, long lo, long hi, long* v) {
+    long long x;
+    if (!batch_llong(s, lo, hi, &x)) return false;
+    *v = (long)x;
+    return true;
+}
+
+bool batch_list(const char* s, int n, long lo, long hi, long* v) {
+    char item[32];
+    for (int i = 0; i < n; ++i) {
+        const char* sep = i + 1 < n ? strchr(s, ',') : s + strlen(s);
+        if (!sep || (size_t)(sep - s) >= sizeof item) return false;
+        memcpy(item, s, (size_t)(sep - s));
+        item[sep - s] = '\0';
+        if (!batch_long(item, lo, hi, &v[i])) return false;
+        s = sep + 1;
+    }
+    return true;
+}
+
+bool batch_seed(const char* s, uint64_t* v) {
+    char* end;
+    while (*s == ' ' || *s == '\t') ++s;
+    if (*s == '-' || *s == '+') return false; /* strtoull молча принимает знак */
+    errno = 0;
+    unsigned long long x = strtoull(s, &end, 0);
+    if (end == s || *end != '\0' || errno == ERANGE) return false;
+    *v = (uint64_t)x;
+    return true;
+}
+
+static bool batch_parse(int argc, char** argv, BatchOpts* o) {
+    o->rows = o->cols = 0;
+    o->tiled_rows = 0;
+    o->tile_rows = 0;
+    o->percent = -1;
+    o->mines = -1;
+    o->count = 1;
+    o->seed = (uint64_t)time(NULL);
+    o->threads = 0;
+    o->queue = 0;
+    o->attempts = 1000;
+    o->start_r = o->start_c = -1;
+    o->repair = 0;
+    o->strength = SOLVER_SUBSET;
+    o->out = "-";
+    o->format = BATCH_TEXT;
+    o->view_r = o->view_c = o->view_h = o->view_w = 0;
+    o->overview_rows = o->overview_cols = 0;
+    o->expand = NULL;
+    o->quiet = false;
+    o->stats = NULL;
+    o->calib = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (strcmp(a, "--quiet") == 0) { o->quiet = true; continue; }
+        if (i + 1 >= argc) { fprintf(stderr, "Нет значения для %s\n", a); return false; }
+        const char* v = argv[++i];
+        long x = 0;
+        bool ok = true;
+
+        if (strcmp(a, "--rows") == 0) ok = batch_llong(v, 1, LLONG_MAX, &o->tiled_rows);
+        else if (strcmp(a, "--cols") == 0) { ok = batch_long(v, 1, INT_MAX - 2, &x); o->cols = (int)x; }
+        else if (strcmp(a, "--tile-rows") == 0) { ok = batch_long(v, 1, 1 << 20, &x); o->tile_rows = (int)x; }
+        else if (strcmp(a, "--density") == 0) { ok = batch_long(v, 0, 100, &x); o->percent = (int)x; }
+        else if (strcmp(a, "--mines") == 0) { ok = batch_long(v, 0, 1L << 30, &x); o->mines = (int)x; }
+        else if (strcmp(a, "--count") == 0) { ok = batch_long(v, 1, 1L << 30, &x); o->count = x; }
+        else if (strcmp(a, "--threads") == 0) { ok = batch_long(v, 0, 1024, &x); o->threads = (int)x; }
+        else if (strcmp(a, "--queue") == 0) { ok = batch_long(v, 1, 1 << 20, &x); o->queue = (int)x; }
+        else if (strcmp(a, "--attempts") == 0) { ok = batch_long(v, 1, 1L << 30, &x); o->attempts = (int)x; }
+        else if (strcmp(a, "--repair") == 0) { ok = batch_long(v, 1, 1L << 20, &x); o->repair = (int)x; }
+        else if (strcmp(a, "--seed") == 0) ok = batch_seed(v, &o->seed);
+        else if (strcmp(a, "--start") == 0) {
+            long rc[2];
+            ok = batch_list(v, 2, 0, INT_MAX, rc);
+            o->start_r = (int)rc[0];
+            o->start_c = (int)rc[1];
+        }
+        else if (strcmp(a, "--view") == 0) {
+            long x4[4];
+            ok = batch_list(v, 4, 0, INT_MAX, x4) && x4[2] > 0 && x4[3] > 0;
+            o->view_r = (int)x4[0];
+            o->view_c = (int)x4[1];
+            o->view_h = (int)x4[2];
+            o->view_w = (int)x4[3];
+        }
+        else if (strcmp(a, "--overview") == 0) {
+            long x2[2];
+            ok = batch_list(v, 2, 1, 1 << 16, x2);
+            o->overview_rows = (int)x2[0];
+            o->overview_cols = (int)x2[1];
+        }
+        else if (strcmp(a, "--strength") == 0) {
+            if (strcmp(v, "basic") == 0) o->strength = SOLVER_BASIC;
+            else if (strcmp(v, "subset") == 0) o->strength = SOLVER_SUBSET;
+            else ok = false;
+        }
+        else if (strcmp(a, "--out") == 0) o->out = v;
+        else if (strcmp(a, "--stats") == 0) o->stats = v;
+        else if (strcmp(a, "--calib") == 0) o->calib = v;
+        else if (strcmp(a, "--expand") == 0) o->expand = v;
+        else if (strcmp(a, "--format") == 0) {
+            if (strcmp(v, "text") == 0) o->format = BATCH_TEXT;
+            else if (strcmp(v, "bin") == 0) o->format = BATCH_BIN;
+            else if (strcmp(v, "desc") == 0) o->format = BATCH_DESC;
+            else ok = false;
+        }
+        else { fprintf(stderr, "Неизвестный параметр %s\n", a); return false; }
+
+        if (!ok) { fprintf(stderr, "Неверное значение %s для %s\n", v, a); return false; }
+    }
+
+    if (o->format != BATCH_TEXT && strcmp(o->out, "-") == 0) {
+        fprintf(stderr, "Двоичный вывод пишется только в файл (--out PATH)\n");
+        return false;
+    }
+    if ((o->view_h > 0 || o->overview_rows > 0) && (o->format != BATCH_TEXT || o->tile_rows > 0
+        || (o->view_h > 0 && o->overview_rows > 0))) {
+        fprintf(stderr, "--view и --overview — только по одному и только для текстового вывода без --tile-rows\n");
+        return false;
+    }
+    if (o->expand) {
+        /* размеры и параметры берутся из дескрипторов */
+        if (o->format == BATCH_DESC) { fprintf(stderr, "--expand пишет поля: --format text|bin\n"); return false; }
+        return true;
+    }
+    if (o->tiled_rows <= 0 || o->cols <= 0) { fprintf(stderr, "Не заданы --rows и --cols\n"); return false; }
+    if (o->tile_rows > 0) {
+        /* потоковый режим: одно поле любой высоты, только по вероятности, в файл */
+        if (o->percent < 0 || strcmp(o->out, "-") == 0 || o->format != BATCH_TEXT) {
+            fprintf(stderr, "--tile-rows требует --density и текстового файла --out PATH\n");
+            return false;
+        }
+        return true;
+    }
+    if (o->tiled_rows > BATCH_MAX_SIDE || o->cols > BATCH_MAX_SIDE) {
+        fprintf(stderr, "Поле больше %dx%d — используйте потоковый режим --tile-rows\n",
+            BATCH_MAX_SIDE, BATCH_MAX_SIDE);
+        return false;
+    }
+    o->rows = (int)o->tiled_rows;
+    if ((o->percent < 0) == (o->mines < 0)) {
+        fprintf(stderr, "Нужен ровно один из параметров --density или --mines\n");
+        return false;
+    }
+    if (o->start_r >= 0 && (o->start_r >= o->rows || o->start_c < 0 || o->start_c >= o->cols)) {
+        fprintf(stderr, "Стартовая клетка --start вне поля\n");
+        return false;
+    }
+    if (o->mines >= 0) {
+        /* то же условие, что у дескриптора поля: мины помещаются вне зоны первого клика */
+        FieldDesc d;
+        fdesc_init(&d, o->rows, o->cols, 0, o->mines, o->start_r, o->start_c, o->strength, 0);
+        if (!fdesc_valid(&d)) {
+            fprintf(stderr, "Мин больше, чем свободных клеток поля (--mines %d)\n", o->mines);
+            return false;
+        }
+    }
+    if (o->repair > 0) {
+        /* поле с починкой не восстанавливается по дескриптору и не похоже на выборку калибровки */
+        if (o->format == BATCH_DESC || o->calib) {
+            fprintf(stderr, "--repair несовместим с --format desc и --calib\n");
+            return false;
+        }
+        if (o->start_r < 0) { o->start_r = o->rows / 2; o->start_c = o->cols / 2; }
+    }
+    return true;
+}
+
+/* Состояние приёмника конвейера: куда и как писать поля */
+typedef struct {
+    const BatchOpts* o;
+    FILE* out;
+    CorpusWriter* corpus;
+    FieldDesc desc;     /* параметры пакета; зерно и вердикт — из GenResult каждого поля */
+    CalibTable* calib;  /* сюда копятся попытки и принятые поля (NULL — без калибровки) */
+    uint64_t t_min, t_max, t_sum;
+    bool write_error;
+} BatchSink;
+
+/* Текстовый вывод поля: целиком (write_field), окном или обзором (render.h) */
+static bool batch_write(const BatchOpts* o, const Field* f, FILE* out) {
+    if (o->view_h > 0) return render_viewport(f, o->view_r, o->view_c, o->view_h, o->view_w, true, out);
+    if (o->overview_rows > 0) return render_overview(f, o->overview_rows, o->overview_cols, out);
+    return write_field(f, out);
+}
+
+/* Вызывается писателем конвейера по порядку номеров полей */
+static bool batch_sink(void* user, uint64_t k, const Field* f, const GenResult* res, uint64_t dt) {
+    BatchSink* b = (BatchSink*)user;
+    const BatchOpts* o = b->o;
+
+    calib_record(b->calib, o->rows, o->cols, calib_percent(o->rows, o->cols, o->percent, o->mines),
+        o->strength, o->start_r >= 0, calib_trials(res), res->solvable ? 1 : 0);
+    if (!res->solvable) {
+        if (!o->quiet)
+            fprintf(stderr, "поле %llu: не решаемо за %d %s, %.3f мс\n", (unsigned long long)k,
+                o->repair > 0 ? o->repair : o->attempts, o->repair > 0 ? "раундов починки" : "попыток", dt / 1e6);
+        return true;
+    }
+
+    /* в двоичном корпусе сохраняем зерно и старт: по ним поле воспроизводится
+       (поле с починкой зерном не описывается — только старт) */
+    CorpusMeta meta = { o->repair > 0 ? CORPUS_HAS_START : CORPUS_HAS_SEED | CORPUS_HAS_START,
+        res->attempt_seed, res->start_r, res->start_c };
+    bool written;
+    if (b->corpus) written = corpus_writer_add(b->corpus, f, &meta);
+    else if (o->format == BATCH_DESC) {
+        fdesc_set_result(&b->desc, res);
+        written = fwrite(&b->desc, sizeof b->desc, 1, b->out) == 1;
+    }
+    else written = batch_write(o, f, b->out);
+    if (!written) {
+        b->write_error = true;
+        return false;
+    }
+    if (dt < b->t_min) b->t_min = dt;
+    if (dt > b->t_max) b->t_max = dt;
+    b->t_sum += dt;
+    if (!o->quiet)
+        fprintf(stderr, "поле %llu: попытка %d, старт (%d,%d), мин %d, %.3f мс\n",
+            (unsigned long long)k, res->attempt, res->start_r, res->start_c, f->mines, dt / 1e6);
+    return true;
+}
+
+/* Потоковый режим: одно огромное поле полосами, без проверки решаемости */
+static int batch_tiled(const BatchOpts* o) {
+    fprintf(stderr, "Потоковый режим: %lldx%d, вероятность %d%%, полосы по %d строк, seed %llu\n",
+        o->tiled_rows, o->cols, o->percent, o->tile_rows, (unsigned long long)o->seed);
+    TiledResult res;
+    uint64_t t0 = mt_now_ns();
+    bool ok = tiled_generate(o->out, o->tiled_rows, o->cols, o->percent, o->seed, o->tile_rows, &res);
+    double total = (mt_now_ns() - t0) / 1e9;
+    if (!ok) {
+        fprintf(stderr, "Ошибка записи в %s\n", o->out);
+        return 1;
+    }
+    double cells = (double)o->tiled_rows * o->cols;
+    fprintf(stderr, "Итого: мин %lld, полос %d, время %.3f с, %.2f нс/клетку, память полосы %.1f МБ\n",
+        res.mines, res.tiles, total, total * 1e9 / cells, res.peak_bytes / 1048576.0);
+    return 0;
+}
+
+/* Рабочее поле под размер rows x cols: пересоздаётся только при смене размера
+   (ctx != NULL — вместе с контекстом солвера). false — не хватило памяти. */
+static bool batch_resize(Field** f, SolverCtx** ctx, int rows, int cols) {
+    if (*f && (*f)->rows == rows && (*f)->cols == cols) return true;
+    field_free(*f);
+    *f = field_create(rows, cols);
+    if (ctx) {
+        solver_ctx_free(*ctx);
+        *ctx = solver_ctx_create(rows, cols);
+    }
+    if (*f && (!ctx || *ctx)) return true;
+    fprintf(stderr, "Ошибка выделения памяти для %dx%d\n", rows, cols);
+    return false;
+}
+
+/* Восстановление полей из файла дескрипторов с перепроверкой вердикта
+   или из двоичного корпуса (распознаётся по сигнатуре) */
+static int batch_expand(const BatchOpts* o) {
+    FILE* in = fopen(o->expand, "rb");
+    if (!in) { fprintf(stderr, "Не удалось открыть %s\n", o->expand); return 1; }
+    char magic[8];
+    bool is_corpus = fread(magic, sizeof magic, 1, in) == 1 && memcmp(magic, CORPUS_MAGIC, sizeof magic) == 0;
+    Corpus* src = NULL;
+    if (is_corpus) {
+        fclose(in);
+        in = NULL;
+        src = corpus_open(o->expand);
+        if (!src) { fprintf(stderr, "Повреждённый корпус %s\n", o->expand); return 1; }
+    }
+    else rewind(in);
+
+    bool to_stdout = strcmp(o->out, "-") == 0;
+    CorpusWriter* corpus = o->format == BATCH_BIN ? corpus_writer_open(o->out) : NULL;
+    FILE* out = o->format == BATCH_BIN ? NULL : to_stdout ? stdout : fopen(o->out, "wb");
+    if (!out && !corpus) {
+        fprintf(stderr, "Не удалось открыть %s\n", o->out);
+        if (in) fclose(in);
+        corpus_close(src);
+        return 1;
+    }
+    if (out) setvbuf(out, NULL, _IOFBF, 1 << 22);
+
+    Field* f = NULL;
+    SolverCtx* ctx = NULL;
+    FieldDesc d;
+    long n = 0, invalid = 0, mismatched = 0;
+    bool write_error = false, alloc_error = false;
+    uint64_t t0 = mt_now_ns();
+
+    for (uint64_t k = 0; src ? k < corpus_count(src) : fread(&d, sizeof d, 1, in) == 1; ++k, ++n) {
+        CorpusMeta meta;
+        if (src) {
+            /* поле корпуса: мины из записи, счётчики — при загрузке */
+            CorpusBoard b;
+            if (!corpus_board(src, k, &b) || !FIELD_FITS_INT(b.rows, b.cols)) {
+                if (!o->quiet) fprintf(stderr, "запись %ld: повреждена\n", n);
+                ++invalid;
+                continue;
+            }
+            if (!batch_resize(&f, NULL, b.rows, b.cols)) { alloc_error = true; break; }
+            corpus_load(src, k, f);
+            meta = b.meta;
+        }
+        else {
+            if (!fdesc_valid(&d) || !FIELD_FITS_INT(d.rows, d.cols)) {
+                if (!o->quiet) fprintf(stderr, "дескриптор %ld: неверный\n", n);
+                ++invalid;
+                continue;
+            }
+            if (!batch_resize(&f, &ctx, (int)d.rows, (int)d.cols)) { alloc_error = true; break; }
+            if (!fdesc_verify(&d, f, ctx)) {
+                if (!o->quiet) fprintf(stderr, "дескриптор %ld: вердикт солвера не совпал\n", n);
+                ++mismatched;
+            }
+            meta.flags = CORPUS_HAS_SEED | CORPUS_HAS_START;
+            meta.seed = d.seed;
+            meta.start_r = d.start_r;
+            meta.start_c = d.start_c;
+        }
+        if (!(corpus ? corpus_writer_add(corpus, f, &meta) : batch_write(o, f, out))) { write_error = true; break; }
+    }
+    field_free(f);
+    solver_ctx_free(ctx);
+    if (in) fclose(in);
+    corpus_close(src);
+    if (corpus) { if (!corpus_writer_close(corpus)) write_error = true; }
+    else {
+        if (fflush(out) != 0) write_error = true;
+        if (!to_stdout && fclose(out) != 0) write_error = true;
+    }
+    if (write_error) fprintf(stderr, "Ошибка записи в %s\n", o->out);
+
+    double total = (mt_now_ns() - t0) / 1e9;
+    fprintf(stderr, "Восстановлено: %s %ld, неверных %ld, вердикт не совпал %ld, время %.3f с\n",
+        src ? "записей корпуса" : "дескрипторов", n, invalid, mismatched, total);
+    return write_error || alloc_error || invalid || mismatched ? 1 : 0;
+}
+
+int run_batch(int argc, char** argv) {
+    BatchOpts o;
+    if (!batch_parse(argc, argv, &o)) { batch_usage(argv[0]); return 2; }
+    if (o.expand) return batch_expand(&o);
+    if (o.tile_rows > 0) return batch_tiled(&o);
+
+    BatchSink sink;
+    memset(&sink, 0, sizeof sink);
+    sink.o = &o;
+    sink.t_min = UINT64_MAX;
+    fdesc_init(&sink.desc, o.rows, o.cols, o.percent, o.mines, o.start_r, o.start_c, o.strength, 0);
+
+    /* калибровка: бюджет попыток по наблюдаемой доле решаемых, а безнадёжные
+       параметры отклоняются до генерации (--attempts — наибольший бюджет) */
+    if (o.calib) {
+        sink.calib = calib_load(o.calib);
+        if (!sink.calib) { fprintf(stderr, "Ошибка выделения памяти\n"); return 1; }
+        int percent = calib_percent(o.rows, o.cols, o.percent, o.mines);
+        CalibPlan plan;
+        calib_plan(sink.calib, o.rows, o.cols, percent, o.strength, o.start_r >= 0, o.attempts, &plan);
+        calib_print_plan(&plan, percent, stderr);
+        if (plan.verdict == CALIB_INFEASIBLE) { calib_free(sink.calib); return 1; }
+        o.attempts = plan.attempts;
+    }
+
+    bool to_stdout = o.format == BATCH_TEXT && strcmp(o.out, "-") == 0;
+    if (o.format == BATCH_BIN) sink.corpus = corpus_writer_open(o.out);
+    else sink.out = to_stdout ? stdout : fopen(o.out, "wb");
+    if (!sink.out && !sink.corpus) {
+        fprintf(stderr, "Не удалось открыть %s\n", o.out);
+        calib_free(sink.calib);
+        return 1;
+    }
+    /* крупный буфер: корпус пишется большими блоками, а не построчно */
+    if (sink.out) setvbuf(sink.out, NULL, _IOFBF, 1 << 22);
+
+    /* генерация и запись идут конвейером: рабочие потоки решают следующие поля,
+       пока этот поток пишет готовые */
+    PipeParams pp;
+    pp.rows = o.rows;
+    pp.cols = o.cols;
+    pp.percent = o.percent;
+    pp.mines = o.mines;
+    pp.start_r = o.start_r;
+    pp.start_c = o.start_c;
+    pp.strength = o.strength;
+    pp.seed = o.seed;
+    pp.max_attempts = o.attempts;
+    pp.repair_rounds = o.repair;
+    pp.count = o.count;
+    pp.max_fails = BATCH_MAX_FAILS;
+    pp.threads = o.threads > 0 ? o.threads : mt_cpu_count();
+    pp.queue_size = o.queue;
+    GenStats gs;
+    stats_clear(&gs);
+    pp.stats = o.stats ? &gs : NULL;
+
+    fprintf(stderr, "Пакетный режим: %dx%d, ", o.rows, o.cols);
+    if (o.mines >= 0) fprintf(stderr, "мин %d", o.mines);
+    else fprintf(stderr, "вероятность %d%%", o.percent);
+    fprintf(stderr, ", полей %ld, seed %llu, потоков %d", o.count, (unsigned long long)o.seed, pp.threads);
+    if (o.repair > 0) fprintf(stderr, ", починка до %d раундов из (%d,%d)", o.repair, o.start_r, o.start_c);
+    fprintf(stderr, "\n");
+
+    PipeStats st;
+    uint64_t t_begin = mt_now_ns();
+    int rc = pipeline_run(&pp, batch_sink, &sink, &st) ? 0 : 1;
+
+    if (st.too_many_fails)
+        fprintf(stderr, "%d полей подряд не решаемы — слишком высокая плотность мин.\n", BATCH_MAX_FAILS);
+    if (sink.corpus) {
+        if (!corpus_writer_close(sink.corpus)) sink.write_error = true;
+    }
+    else {
+        if (fflush(sink.out) != 0) sink.write_error = true;
+        if (!to_stdout && fclose(sink.out) != 0) sink.write_error = true;
+    }
+    if (sink.write_error) { fprintf(stderr, "Ошибка записи в %s\n", o.out); rc = 1; }
+    double total = (mt_now_ns() - t_begin) / 1e9;
+
+    fprintf(stderr, "Итого: полей %ld, отброшено %ld, попыток %ld, время %.3f с",
+        st.made, st.failed, st.attempts, total);
+    if (st.made > 0)
+        fprintf(stderr, ", %.1f полей/с, генерация поля: ср. %.3f / мин. %.3f / макс. %.3f мс",
+            st.made / total, sink.t_sum / 1e6 / st.made, sink.t_min / 1e6, sink.t_max / 1e6);
+    fprintf(stderr, "\n");
+
+    if (o.stats) {
+        if (!stats_enabled()) fprintf(stderr, "Статистика пуста: программа собрана без FIELD_STATS.\n");
+        FILE* sf = strcmp(o.stats, "-") == 0 ? stderr : fopen(o.stats, "w");
+        if (!sf) { fprintf(stderr, "Не удалось открыть %s\n", o.stats); rc = 1; }
+        else {
+            stats_write_json(&gs, sf);
+            if (sf != stderr) fclose(sf);
+        }
+    }
+    if (sink.calib && !calib_save(sink.calib, o.calib)) {
+        fprintf(stderr, "Не удалось сохранить калибровку в %s\n", o.calib);
+        rc = 1;
+    }
+    calib_free(sink.calib);
+    return rc;
+}
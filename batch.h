@@ -0,0 +1,65 @@
+#ifndef MINES_BATCH_H
+#define MINES_BATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* -------------------------------------------------------------------
+   Пакетный (неинтерактивный) режим: генерация корпуса решаемых полей
+   по параметрам командной строки, без вопросов пользователю.
+   ------------------------------------------------------------------- */
+
+/* run_batch
+   - Разбирает аргументы командной строки (argv[0] — имя программы):
+       --rows R --cols C          размер поля (обязательно)
+       --density P | --mines M    вероятность мины в процентах или точное число мин
+       --count N                  сколько решаемых полей получить (по умолчанию 1)
+       --seed S                   зерно корпуса (по умолчанию — от времени)
+       --threads T                число потоков генератора (0 = по числу ядер)
+       --queue Q                  ёмкость очереди готовых полей конвейера
+       --attempts A               попыток на одно поле (по умолчанию 1000)
+       --start R,C                генерация под известный первый клик
+       --strength basic|subset    уровень рассуждений солвера
+       --repair ROUNDS            генерация с починкой (generate_repair) вместо отбраковки:
+                                  одно поле на номер, до ROUNDS раундов переноса мин; старт —
+                                  --start или центр поля; не сочетается с desc и --calib
+       --out PATH                 файл корпуса ("-" — стандартный вывод)
+       --format text|bin|desc     текст (write_field), двоичный корпус (corpus.h)
+                                  или 32-байтные дескрипторы полей (fielddesc.h)
+       --stats PATH               записать статистику генерации в JSON ("-" — stderr);
+                                  счётчики собираются при сборке с FIELD_STATS
+       --calib PATH               таблица калибровки (calib.h): бюджет попыток по
+                                  наблюдаемой доле решаемых (не больше --attempts),
+                                  безнадёжные параметры — отказ с подсказкой плотности
+                                  до генерации; итоги запуска дописываются в таблицу
+       --tile-rows N              потоковая генерация одного поля любой высоты
+                                  полосами по N строк (tiled.h), только с --density;
+                                  решаемость не проверяется
+       --view R0,C0,H,W           вместо поля целиком — окно из H строк и W столбцов
+                                  с клетки (R0,C0) (render_viewport), только текст
+       --overview ROWS,COLS       вместо поля — уменьшенный обзор не больше ROWS x COLS
+                                  символов (render_overview), только текст
+       --quiet                    не печатать строку на каждое поле
+   - --expand PATH [--out PATH] [--format text|bin] [--view | --overview]: вместо генерации восстановить
+     поля из файла дескрипторов и перепроверить вердикт солвера каждого; двоичный
+     корпус (corpus.h) распознаётся по сигнатуре и переписывается через corpus_load.
+   - Поле номер k строится из зерна rng_derive(seed, k), поэтому корпус
+     воспроизводим по seed при любом числе потоков.
+   - Поля генерируются конвейером (pipeline.h): потоки решают поля, пока
+     вызывающий поток пишет готовые.
+   - Отчёт (время на каждое поле и итог) печатается в stderr.
+   - Возвращает код завершения программы (0 — успех).
+*/
+int run_batch(int argc, char** argv);
+
+/* batch_long / batch_seed / batch_list
+   - Строгий разбор значения параметра командной строки (пакет и сервис):
+     десятичное целое в [lo, hi] / 64-битное зерно (десятичное или 0x...) /
+     ровно n целых в [lo, hi] через запятую ("R,C") в v[0..n-1].
+   - false при пустой строке, знаке у зерна, мусоре после числа или выходе за диапазон.
+*/
+bool batch_long(const char* s, long lo, long hi, long* v);
+bool batch_seed(const char* s, uint64_t* v);
+bool batch_list(const char* s, int n, long lo, long hi, long* v);
+
+#endif /* MINES_BATCH_H */
@@ -0,0 +1,202 @@
+#include "field.h"
+#include "mt.h"
+#include "parfield.h"
+#include "bitsolve.h"
+
+/* -------------------------------------------------------------------
+   Микробенчмарк ядер поля: compute_counts, generate_by_probability,
+   validate_field (без печати — validate_field_quiet), их полосные
+   многопоточные версии (parfield.h), simulate_solver_from, тот же солвер
+   на готовом контексте, битовый солвер (bitsolve.h), check_solvability и
+   генерацию с починкой (generate_repair, SOLVER_BASIC) на матрице
+   размеров (9x9 .. 4096x4096) и плотностей мин.
+   Каждый замер повторяет вызов, пока не наберётся min_time, и выводит
+   нс на вызов, нс на клетку и полей в секунду. Форматы: таблица (по
+   умолчанию), CSV и JSON — для сравнения между версиями.
+
+   Параметры:
+     --format table|csv|json
+     --min-time MS     минимальное время одного замера (по умолчанию 100)
+     --max-side N      пропускать поля со стороной больше N
+     --seed S          зерно расстановки мин
+     --threads N       потоков для *_mt ядер (по умолчанию по числу ядер)
+     --full            не ограничивать размер для check_solvability
+   ------------------------------------------------------------------- */
+
+typedef enum { OUT_TABLE, OUT_CSV, OUT_JSON } OutFormat;
+
+/* Подготовленное поле одного замера */
+typedef struct {
+    Field* f;
+    int percent;
+    Rng rng;
+    int start_r, start_c;   /* стартовая клетка для simulate_solver_from */
+    MtPool* pool;           /* потоки для *_mt ядер */
+    SolverCtx* ctx;         /* контекст для simulate_solver_ctx */
+    BitSolver* bits;        /* для bitsolver_solve */
+} BenchCase;
+
+typedef struct {
+    const char* name;
+    void (*run)(BenchCase* bc);
+    int max_side;           /* больше — пропуск без --full (0 — без ограничения) */
+} BenchKernel;
+
+/* Раундов починки на поле для generate_repair */
+#define BENCH_REPAIR_ROUNDS 1000
+
+static void run_compute_counts(BenchCase* bc) { compute_counts(bc->f); }
+static void run_generate(BenchCase* bc) { generate_by_probability(bc->f, bc->percent); }
+static void run_validate(BenchCase* bc) { validate_field_quiet(bc->f); }
+static void run_compute_counts_mt(BenchCase* bc) { compute_counts_mt(bc->f, bc->pool); }
+static void run_validate_mt(BenchCase* bc) { validate_field_mt(bc->f, bc->pool, NULL, 0); }
+static void run_simulate(BenchCase* bc) { simulate_solver_from(bc->f, bc->start_r, bc->start_c); }
+static void run_simulate_ctx(BenchCase* bc) { simulate_solver_ctx(bc->f, bc->ctx, bc->start_r, bc->start_c); }
+/* загрузка мин в битовые плоскости входит в замер: её делает каждый вызывающий */
+static void run_bitsolver(BenchCase* bc) {
+    bitsolver_load(bc->bits, bc->f);
+    bitsolver_solve(bc->bits, bc->start_r, bc->start_c);
+}
+static void run_check(BenchCase* bc) { check_solvability(bc->f, NULL, NULL); }
+/* поле строится заново из центра: замер — целая генерация с починкой */
+static void run_repair(BenchCase* bc) {
+    generate_repair(bc->f, bc->ctx, bc->percent, -1, bc->f->rows / 2, bc->f->cols / 2,
+        BENCH_REPAIR_ROUNDS, &bc->rng, NULL);
+}
+
+/* check_solvability на плотных полях растёт быстрее площади:
+   поле 1024x1024 при 20% проверяется секунды, 4096x4096 — минуты */
+static const BenchKernel KERNELS[] = {
+    { "compute_counts",          run_compute_counts, 0 },
+    { "generate_by_probability", run_generate,       0 },
+    { "validate_field_quiet",    run_validate,       0 },
+    { "compute_counts_mt",       run_compute_counts_mt, 0 },
+    { "validate_field_mt",       run_validate_mt,    0 },
+    { "simulate_solver_from",    run_simulate,       0 },
+    { "simulate_solver_ctx",     run_simulate_ctx,   0 },
+    { "bitsolver_solve",         run_bitsolver,      0 },
+    { "check_solvability",       run_check,          1024 },
+    { "generate_repair",         run_repair,         1024 },
+};
+
+static const int SIZES[][2] = {
+    { 9, 9 }, { 16, 16 }, { 16, 30 }, { 64, 64 }, { 256, 256 }, { 1024, 1024 }, { 4096, 4096 },
+};
+static const int DENSITIES[] = { 10, 15, 20 };
+
+#define COUNT_OF(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+/* Свежая расстановка мин для замера: у всех ядер одинаковое исходное поле */
+static void bench_prepare(BenchCase* bc, uint64_t seed) {
+    rng_seed(&bc->rng, seed);
+    generate_by_probability_rng(bc->f, bc->percent, &bc->rng);
+
+    /* старт — первая нулевая клетка (иначе первая клетка без мины) */
+    bc->start_r = bc->start_c = 0;
+    bool found_safe = false;
+    for (int r = 0; r < bc->f->rows; ++r)
+        for (int c = 0; c < bc->f->cols; ++c) {
+            if (FIELD_MINE(bc->f, r, c)) continue;
+            if (FIELD_COUNT(bc->f, r, c) == 0) { bc->start_r = r; bc->start_c = c; return; }
+            if (!found_safe) { bc->start_r = r; bc->start_c = c; found_safe = true; }
+        }
+}
+
+/* Повторяет ядро, пока не пройдёт min_ns; возвращает среднее время вызова */
+static double bench_time(const BenchKernel* k, BenchCase* bc, uint64_t min_ns, long* iters) {
+    long n = 0;
+    uint64_t t0 = mt_now_ns(), dt;
+    do {
+        k->run(bc);
+        ++n;
+        dt = mt_now_ns() - t0;
+    } while (dt < min_ns);
+    *iters = n;
+    return (double)dt / n;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Использование: %s [--format table|csv|json] [--min-time MS] [--max-side N] [--seed S] [--threads N] [--full]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    OutFormat fmt = OUT_TABLE;
+    uint64_t min_ns = 100ULL * 1000000ULL;
+    int max_side = 1 << 30;
+    uint64_t seed = 12345;
+    bool full = false;
+    int threads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--full") == 0) full = true;
+        else if (strcmp(a, "--format") == 0 && v) {
+            ++i;
+            if (strcmp(v, "table") == 0) fmt = OUT_TABLE;
+            else if (strcmp(v, "csv") == 0) fmt = OUT_CSV;
+            else if (strcmp(v, "json") == 0) fmt = OUT_JSON;
+            else { usage(argv[0]); return 2; }
+        }
+        else if (strcmp(a, "--min-time") == 0 && v) { ++i; min_ns = strtoull(v, NULL, 10) * 1000000ULL; }
+        else if (strcmp(a, "--max-side") == 0 && v) { ++i; max_side = atoi(v); }
+        else if (strcmp(a, "--seed") == 0 && v) { ++i; seed = strtoull(v, NULL, 0); }
+        else if (strcmp(a, "--threads") == 0 && v) { ++i; threads = atoi(v); }
+        else { usage(argv[0]); return 2; }
+    }
+    srand((unsigned)seed); /* generate_by_probability берёт зерно из rand() */
+    MtPool* pool = mt_pool_create(threads);
+    if (!pool) { fprintf(stderr, "Не удалось создать пул потоков\n"); return 1; }
+
+    if (fmt == OUT_TABLE)
+        printf("%-24s %11s %4s %9s %14s %10s %14s\n",
+            "kernel", "size", "%", "iters", "ns/call", "ns/cell", "boards/s");
+    else if (fmt == OUT_CSV)
+        printf("kernel,rows,cols,density,iters,ns_per_call,ns_per_cell,boards_per_sec\n");
+    else
+        printf("{\"seed\": %llu, \"threads\": %d, \"results\": [", (unsigned long long)seed, mt_pool_threads(pool));
+
+    bool first = true;
+    for (int s = 0; s < COUNT_OF(SIZES); ++s) {
+        int rows = SIZES[s][0], cols = SIZES[s][1];
+        if (rows > max_side || cols > max_side) continue;
+        BenchCase bc;
+        bc.pool = pool;
+        bc.f = field_create(rows, cols);
+        bc.ctx = solver_ctx_create(rows, cols);
+        bc.bits = bitsolver_create(rows, cols);
+        if (!bc.f || !bc.ctx || !bc.bits) { fprintf(stderr, "Ошибка выделения памяти для %dx%d\n", rows, cols); return 1; }
+
+        for (int d = 0; d < COUNT_OF(DENSITIES); ++d) {
+            bc.percent = DENSITIES[d];
+            for (int k = 0; k < COUNT_OF(KERNELS); ++k) {
+                const BenchKernel* kern = &KERNELS[k];
+                if (!full && kern->max_side && (rows > kern->max_side || cols > kern->max_side)) continue;
+
+                bench_prepare(&bc, seed);
+                long iters;
+                double ns = bench_time(kern, &bc, min_ns, &iters);
+                double cells = (double)rows * cols;
+
+                if (fmt == OUT_TABLE)
+                    printf("%-24s %5dx%-5d %4d %9ld %14.0f %10.3f %14.1f\n",
+                        kern->name, rows, cols, bc.percent, iters, ns, ns / cells, 1e9 / ns);
+                else if (fmt == OUT_CSV)
+                    printf("%s,%d,%d,%d,%ld,%.1f,%.4f,%.3f\n",
+                        kern->name, rows, cols, bc.percent, iters, ns, ns / cells, 1e9 / ns);
+                else
+                    printf("%s\n  {\"kernel\": \"%s\", \"rows\": %d, \"cols\": %d, \"density\": %d, "
+                        "\"iters\": %ld, \"ns_per_call\": %.1f, \"ns_per_cell\": %.4f, \"boards_per_sec\": %.3f}",
+                        first ? "" : ",", kern->name, rows, cols, bc.percent, iters, ns, ns / cells, 1e9 / ns);
+                first = false;
+                fflush(stdout);
+            }
+        }
+        field_free(bc.f);
+        solver_ctx_free(bc.ctx);
+        bitsolver_free(bc.bits);
+    }
+    if (fmt == OUT_JSON) printf("\n]}\n");
+    mt_pool_free(pool);
+    return 0;
+}
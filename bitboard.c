@@ -0,0 +1,141 @@
+#include "bitboard.h"
+
+BitField* bitfield_create(int rows, int cols) {
+    if (rows <= 0 || cols <= 0) return NULL;
+    BitField* b = (BitField*)malloc(sizeof(BitField));
+    if (!b) return NULL;
+    b->rows = rows;
+    b->cols = cols;
+    b->words = (cols + 63) / 64;
+    b->bits = (uint64_t*)calloc((size_t)rows * b->words, sizeof(uint64_t));
+    if (!b->bits) { free(b); return NULL; }
+    return b;
+}
+
+void bitfield_free(BitField* b) {
+    if (!b) return;
+    free(b->bits);
+    free(b);
+}
+
+/* Собирает младшие биты 8 байт в один байт (байт i -> бит i) */
+static inline uint64_t gather8(const unsigned char* p) {
+    uint64_t x;
+    memcpy(&x, p, 8);
+    return ((x & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56;
+}
+
+/* Обратная операция: бит i байта -> младший бит байта i.
+   Байт размножается на все 8 позиций, в позиции i остаётся только бит i,
+   затем ненулевые байты превращаются в 1 через перенос в старший бит. */
+static inline uint64_t spread8(uint64_t byte) {
+    uint64_t x = (byte * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+    return ((x + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+}
+
+void bitfield_from_field(BitField* b, const Field* f) {
+    if (!b || !f || b->rows != f->rows || b->cols != f->cols) return;
+    int C = f->cols;
+    for (int r = 0; r < b->rows; ++r) {
+        const unsigned char* src = &f->is_mine[IDX(f, r, 0)];
+        uint64_t* dst = BITROW(b, r);
+        for (int w = 0; w < b->words; ++w) {
+            int c0 = w * 64, n = C - c0 < 64 ? C - c0 : 64;
+            uint64_t word = 0;
+            int k = 0;
+            for (; k + 8 <= n; k += 8) word |= gather8(src + c0 + k) << k;
+            for (; k < n; ++k) word |= (uint64_t)(src[c0 + k] & 1) << k;
+            dst[w] = word;
+        }
+    }
+}
+
+int bitfield_count_mines(const BitField* b) {
+    if (!b) return 0;
+    int total = 0;
+    size_t n = (size_t)b->rows * b->words;
+    for (size_t i = 0; i < n; ++i) total += bit_popcount64(b->bits[i]);
+    return total;
+}
+
+/* Полный сумматор над 64 независимыми битами */
+#define FULL_ADD(s, cy, a, b, c) do { uint64_t t_ = (a) ^ (b); \
+    (s) = t_ ^ (c); (cy) = ((a) & (b)) | (t_ & (c)); } while (0)
+
+void bitfield_compute_counts(const BitField* b, Field* f) {
+    if (!b || !f || b->rows != f->rows || b->cols != f->cols) return;
+    int R = b->rows, C = b->cols, W = b->words;
+    unsigned char tmp[64];
+
+    for (int r = 0; r < R; ++r) {
+        const uint64_t* up = r > 0 ? BITROW(b, r - 1) : NULL;
+        const uint64_t* mid = BITROW(b, r);
+        const uint64_t* dn = r + 1 < R ? BITROW(b, r + 1) : NULL;
+        unsigned char* out = &f->count[IDX(f, r, 0)];
+
+        for (int w = 0; w < W; ++w) {
+            /* слово строки и его сдвиги: L — сосед слева (c-1), Rt — сосед справа (c+1) */
+            uint64_t u = up ? up[w] : 0, m = mid[w], d = dn ? dn[w] : 0;
+            uint64_t up_prev = (up && w > 0) ? up[w - 1] >> 63 : 0;
+            uint64_t up_next = (up && w + 1 < W) ? up[w + 1] << 63 : 0;
+            uint64_t m_prev = w > 0 ? mid[w - 1] >> 63 : 0;
+            uint64_t m_next = w + 1 < W ? mid[w + 1] << 63 : 0;
+            uint64_t d_prev = (dn && w > 0) ? dn[w - 1] >> 63 : 0;
+            uint64_t d_next = (dn && w + 1 < W) ? dn[w + 1] << 63 : 0;
+
+            uint64_t a1 = (u << 1) | up_prev, a2 = u, a3 = (u >> 1) | up_next;
+            uint64_t a4 = (m << 1) | m_prev, a5 = (m >> 1) | m_next;
+            uint64_t a6 = (d << 1) | d_prev, a7 = d, a8 = (d >> 1) | d_next;
+
+            /* дерево сумматоров: 8 входов веса 1 -> разряды b0..b3 */
+            uint64_t s1, c1, s2, c2, s3, c3, b0, c4, t, c5, b1, c6;
+            FULL_ADD(s1, c1, a1, a2, a3);
+            FULL_ADD(s2, c2, a4, a5, a6);
+            s3 = a7 ^ a8; c3 = a7 & a8;
+            FULL_ADD(b0, c4, s1, s2, s3);
+            FULL_ADD(t, c5, c1, c2, c3);
+            b1 = t ^ c4; c6 = t & c4;
+            uint64_t b2 = c5 ^ c6, b3 = c5 & c6;
+
+            /* у мин счётчик 0 */
+            uint64_t keep = ~m;
+            b0 &= keep; b1 &= keep; b2 &= keep; b3 &= keep;
+
+            int c0 = w * 64, n = C - c0 < 64 ? C - c0 : 64;
+            for (int k = 0; k < 64; k += 8) {
+                uint64_t bytes = spread8((b0 >> k) & 0xFF)
+                    | spread8((b1 >> k) & 0xFF) << 1
+                    | spread8((b2 >> k) & 0xFF) << 2
+                    | spread8((b3 >> k) & 0xFF) << 3;
+                memcpy(tmp + k, &bytes, 8);
+            }
+            memcpy(out + c0, tmp, n);
+        }
+    }
+}
+
+void bitfield_to_field(const BitField* b, Field* f) {
+    if (!b || !f || b->rows != f->rows || b->cols != f->cols) return;
+    int C = b->cols;
+    unsigned char tmp[64];
+    for (int r = 0; r < b->rows; ++r) {
+        const uint64_t* row = BITROW(b, r);
+        unsigned char* out = &f->is_mine[IDX(f, r, 0)];
+        for (int w = 0; w < b->words; ++w) {
+            for (int k = 0; k < 64; k += 8) {
+                uint64_t bytes = spread8((row[w] >> k) & 0xFF);
+                memcpy(tmp + k, &bytes, 8);
+            }
+            int c0 = w * 64, n = C - c0 < 64 ? C - c0 : 64;
+            memcpy(out + c0, tmp, n);
+        }
+    }
+    f->mines = bitfield_count_mines(b);
+    bitfield_compute_counts(b, f);
+}
+
+void compute_counts_bits(Field* f, BitField* scratch) {
+    if (!f || !scratch) return;
+    bitfield_from_field(scratch, f);
+    bitfield_compute_counts(scratch, f);
+}
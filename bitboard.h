@@ -0,0 +1,75 @@
+#ifndef MINES_BITBOARD_H
+#define MINES_BITBOARD_H
+
+#include "field.h"
+#include <stdint.h>
+
+/* -------------------------------------------------------------------
+   BitField: битовое представление расстановки мин.
+   Один бит на клетку, строка занимает words 64-битных слов:
+   клетка (r,c) — бит (c % 64) слова bits[r * words + c / 64].
+   Биты за пределами cols в последнем слове строки всегда равны 0.
+   Хранение мин в 8 раз компактнее массива is_mine, а счётчики
+   считаются сразу для 64 клеток битовыми сумматорами (bit-sliced).
+   Байтовые массивы Field остаются "материализованным" видом
+   для print_field_ascii, save_field_to_file и солвера.
+   ------------------------------------------------------------------- */
+typedef struct {
+    int rows;
+    int cols;
+    int words;      /* 64-битных слов на строку: (cols + 63) / 64 */
+    uint64_t* bits;
+} BitField;
+
+/* Строка r битового поля */
+#define BITROW(b, r) ((b)->bits + (size_t)(r) * (b)->words)
+
+/* Число единичных битов в слове */
+static inline int bit_popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/* bitfield_create / bitfield_free
+   - Выделяет пустое битовое поле rows x cols. Возвращает NULL при ошибке.
+   - bitfield_free безопасно вызывать с NULL.
+*/
+BitField* bitfield_create(int rows, int cols);
+void bitfield_free(BitField* b);
+
+/* bitfield_from_field
+   - Упаковывает f->is_mine в биты (размеры b и f должны совпадать).
+*/
+void bitfield_from_field(BitField* b, const Field* f);
+
+/* bitfield_count_mines
+   - Число мин в битовом поле (popcount по словам).
+*/
+int bitfield_count_mines(const BitField* b);
+
+/* bitfield_compute_counts
+   - Считает f->count по битовому полю: для каждой строки восемь сдвинутых слов
+     соседних строк складываются битовыми полными сумматорами в 4 разряда (0..8),
+     затем разряды раскладываются в байты по 8 клеток за раз.
+   - Для мин счётчик равен 0, как в compute_counts. f->is_mine не изменяется.
+*/
+void bitfield_compute_counts(const BitField* b, Field* f);
+
+/* bitfield_to_field
+   - Материализует байтовый вид: заполняет f->is_mine, f->mines и f->count.
+*/
+void bitfield_to_field(const BitField* b, Field* f);
+
+/* compute_counts_bits
+   - Быстрая замена compute_counts для больших полей: упаковывает f->is_mine
+     во вспомогательное битовое поле scratch и считает счётчики по нему.
+*/
+void compute_counts_bits(Field* f, BitField* scratch);
+
+#endif /* MINES_BITBOARD_H */
@@ -0,0 +1,293 @@
+#include "bitsolve.h"
+
+/* Плоскости хранятся с двумя пустыми строками сверху и снизу, чтобы окрестность
+   строки r (r-2..r+2) читалась без проверок */
+#define BS_PAD 2
+#define BS_ROW(s, plane, r) ((plane) + (size_t)((r) + BS_PAD) * (s)->words)
+
+struct BitSolver {
+    int rows, cols, words;
+    long long mines;
+    long long opened;
+    uint64_t* mine;
+    uint64_t* open;
+    uint64_t* flag;
+    uint64_t* valid;        /* маска клеток строки (хвост последнего слова обнулён) */
+    uint64_t* none;         /* пустая строка для соседей за пределами поля */
+    uint64_t* tmp;          /* строки-черновики bitsolver_row */
+    int* pend_lo;           /* слова строки, ждущие пересчёта: [pend_lo, pend_hi] */
+    int* pend_hi;
+};
+
+BitSolver* bitsolver_create(int rows, int cols) {
+    if (rows <= 0 || cols <= 0) return NULL;
+    BitSolver* s = (BitSolver*)calloc(1, sizeof(BitSolver));
+    if (!s) return NULL;
+    s->rows = rows;
+    s->cols = cols;
+    s->words = (cols + 63) / 64;
+    size_t plane = (size_t)(rows + 2 * BS_PAD) * s->words;
+    s->mine = (uint64_t*)calloc(plane, sizeof(uint64_t));
+    s->open = (uint64_t*)calloc(plane, sizeof(uint64_t));
+    s->flag = (uint64_t*)calloc(plane, sizeof(uint64_t));
+    s->valid = (uint64_t*)malloc((size_t)s->words * sizeof(uint64_t));
+    s->none = (uint64_t*)calloc((size_t)s->words, sizeof(uint64_t));
+    s->tmp = (uint64_t*)malloc((size_t)s->words * 8 * sizeof(uint64_t));
+    s->pend_lo = (int*)malloc((size_t)rows * sizeof(int));
+    s->pend_hi = (int*)malloc((size_t)rows * sizeof(int));
+    if (!s->mine || !s->open || !s->flag || !s->valid || !s->none || !s->tmp || !s->pend_lo || !s->pend_hi) {
+        bitsolver_free(s);
+        return NULL;
+    }
+    for (int w = 0; w < s->words; ++w) s->valid[w] = ~0ULL;
+    if (cols % 64) s->valid[s->words - 1] = (1ULL << (cols % 64)) - 1;
+    return s;
+}
+
+void bitsolver_free(BitSolver* s) {
+    if (!s) return;
+    free(s->mine);
+    free(s->open);
+    free(s->flag);
+    free(s->valid);
+    free(s->none);
+    free(s->tmp);
+    free(s->pend_lo);
+    free(s->pend_hi);
+    free(s);
+}
+
+static void bitsolver_count_mines(BitSolver* s) {
+    s->mines = 0;
+    const uint64_t* m = BS_ROW(s, s->mine, 0);
+    for (size_t i = 0; i < (size_t)s->rows * s->words; ++i) s->mines += bit_popcount64(m[i]);
+}
+
+bool bitsolver_load(BitSolver* s, const Field* f) {
+    if (!s || !f || f->rows != s->rows || f->cols != s->cols) return false;
+    BitField view = { s->rows, s->cols, s->words, BS_ROW(s, s->mine, 0) };
+    bitfield_from_field(&view, f);
+    bitsolver_count_mines(s);
+    return true;
+}
+
+bool bitsolver_load_bits(BitSolver* s, const BitField* mines) {
+    if (!s || !mines || mines->rows != s->rows || mines->cols != s->cols) return false;
+    memcpy(BS_ROW(s, s->mine, 0), mines->bits, (size_t)s->rows * s->words * sizeof(uint64_t));
+    bitsolver_count_mines(s);
+    return true;
+}
+
+/* Слово w строки x, расширенное на клетку влево и вправо (с переносом между словами) */
+static inline uint64_t hdil(const uint64_t* x, int w, int W) {
+    uint64_t v = x[w] | (x[w] << 1) | (x[w] >> 1);
+    if (w > 0) v |= x[w - 1] >> 63;
+    if (w + 1 < W) v |= x[w + 1] << 63;
+    return v;
+}
+
+/* Заливка с препятствиями внутри слова: g растёт по подряд идущим битам p
+   в сторону старших (up) или младших битов за log2(64) шагов */
+static inline uint64_t fill_up(uint64_t g, uint64_t p) {
+    g |= p & (g << 1);  p &= p << 1;
+    g |= p & (g << 2);  p &= p << 2;
+    g |= p & (g << 4);  p &= p << 4;
+    g |= p & (g << 8);  p &= p << 8;
+    g |= p & (g << 16); p &= p << 16;
+    return g | (p & (g << 32));
+}
+
+static inline uint64_t fill_down(uint64_t g, uint64_t p) {
+    g |= p & (g >> 1);  p &= p >> 1;
+    g |= p & (g >> 2);  p &= p >> 2;
+    g |= p & (g >> 4);  p &= p >> 4;
+    g |= p & (g >> 8);  p &= p >> 8;
+    g |= p & (g >> 16); p &= p >> 16;
+    return g | (p & (g >> 32));
+}
+
+static inline const uint64_t* bs_valid(const BitSolver* s, int q) {
+    return (q >= 0 && q < s->rows) ? s->valid : s->none;
+}
+
+/* Нулевые клетки слова w строки r: безопасные клетки без мин вокруг */
+static inline uint64_t bs_zero(const BitSolver* s, int r, int w) {
+    int W = s->words;
+    const uint64_t *m0 = BS_ROW(s, s->mine, r - 1), *m1 = BS_ROW(s, s->mine, r), *m2 = BS_ROW(s, s->mine, r + 1);
+    uint64_t v = m0[w] | m1[w] | m2[w];
+    uint64_t d = v | (v << 1) | (v >> 1);
+    if (w > 0) d |= (m0[w - 1] | m1[w - 1] | m2[w - 1]) >> 63;
+    if (w + 1 < W) d |= (m0[w + 1] | m1[w + 1] | m2[w + 1]) << 63;
+    return s->valid[w] & ~d;
+}
+
+/* Клетки строк r-1..r+1, к которым применимы правила B (в b) и A (в a),
+   в словах [lo, hi]; vm и vs — черновики на слова [lo-1, hi+1] */
+static void bitsolver_rule_cells(const BitSolver* s, int r, int lo, int hi,
+    uint64_t* b, uint64_t* a, uint64_t* vm, uint64_t* vs) {
+    int W = s->words;
+    int vlo = lo > 0 ? lo - 1 : 0, vhi = hi + 1 < W ? hi + 1 : W - 1;
+    for (int w = lo; w <= hi; ++w) b[w] = a[w] = 0;
+    for (int q = r - 1; q <= r + 1; ++q) {
+        if (q < 0 || q >= s->rows) continue;
+        /* vm: непомеченные мины, vs: закрытые безопасные клетки в строках q-1..q+1 */
+        for (int w = vlo; w <= vhi; ++w) {
+            uint64_t m = 0, c = 0;
+            for (int d = -1; d <= 1; ++d) {
+                const uint64_t* mi = BS_ROW(s, s->mine, q + d);
+                m |= mi[w] & ~BS_ROW(s, s->flag, q + d)[w];
+                c |= bs_valid(s, q + d)[w] & ~BS_ROW(s, s->open, q + d)[w] & ~mi[w];
+            }
+            vm[w] = m;
+            vs[w] = c;
+        }
+        const uint64_t* op = BS_ROW(s, s->open, q);
+        for (int w = lo; w <= hi; ++w) {
+            b[w] |= op[w] & ~hdil(vm, w, W);
+            a[w] |= op[w] & ~hdil(vs, w, W);
+        }
+    }
+}
+
+/* Слово w строки g, где g задана только на [lo, hi] (вне — нули) */
+static inline uint64_t bs_word(const uint64_t* g, int lo, int hi, int w) {
+    return (w >= lo && w <= hi) ? g[w] : 0;
+}
+
+/* Пересчёт слов [lo, hi] строки r до устойчивости.
+   Возвращает true и диапазон изменившихся слов [*clo, *chi], если строка изменилась
+   (заливка нулей может выйти за [lo, hi]). */
+static bool bitsolver_row(BitSolver* s, int r, int lo, int hi, int* clo, int* chi) {
+    int W = s->words;
+    uint64_t *b = s->tmp, *a = b + W, *vm = a + W, *vs = vm + W, *g = vs + W;
+    uint64_t* op = BS_ROW(s, s->open, r);
+    uint64_t* fl = BS_ROW(s, s->flag, r);
+    int blo = lo > 0 ? lo - 1 : 0, bhi = hi + 1 < W ? hi + 1 : W - 1;
+    bool changed = false;
+
+    for (;;) {
+        bool ch = false;
+        bitsolver_rule_cells(s, r, blo, bhi, b, a, vm, vs);
+        for (int w = lo; w <= hi; ++w) {
+            uint64_t closed = s->valid[w] & ~op[w] & ~fl[w];
+            uint64_t safe = hdil(b, w, W) & closed;
+            uint64_t mine = hdil(a, w, W) & closed;
+            if (!(safe | mine)) continue;
+            op[w] |= safe;
+            fl[w] |= mine;
+            if (!ch && !changed) *clo = *chi = w;
+            if (w < *clo) *clo = w;
+            if (w > *chi) *chi = w;
+            ch = true;
+        }
+
+        /* открытые нули заливают свои отрезки нулей (в обе стороны, пока идёт перенос)
+           и открывают соседей по строке */
+        int flo = lo, fhi = lo;
+        uint64_t carry = 0;
+        for (int w = lo; w < W && (w <= hi || carry); ++w) {
+            uint64_t z = bs_zero(s, r, w);
+            g[w] = fill_up((op[w] & z) | (carry & z), z);
+            carry = g[w] >> 63;
+            fhi = w;
+        }
+        carry = 0;
+        for (int w = fhi; w >= 0 && (w >= lo || carry); --w) {
+            uint64_t z = bs_zero(s, r, w);
+            uint64_t x = w >= lo ? g[w] : op[w] & z;
+            g[w] = fill_down(x | ((carry << 63) & z), z);
+            carry = g[w] & 1;
+            flo = w;
+        }
+        for (int w = flo > 0 ? flo - 1 : 0; w <= fhi + 1 && w < W; ++w) {
+            uint64_t x = bs_word(g, flo, fhi, w);
+            uint64_t d = x | (x << 1) | (x >> 1)
+                | (bs_word(g, flo, fhi, w - 1) >> 63) | (bs_word(g, flo, fhi, w + 1) << 63);
+            uint64_t add = d & s->valid[w] & ~op[w];
+            if (!add) continue;
+            op[w] |= add;
+            if (!ch && !changed) *clo = *chi = w;
+            if (w < *clo) *clo = w;
+            if (w > *chi) *chi = w;
+            ch = true;
+        }
+        if (!ch) break;
+        changed = true;
+    }
+    return changed;
+}
+
+/* Изменение слов [lo, hi] строки r затрагивает правила в строках r-2..r+2
+   и словах [lo-1, hi+1]: добавляем их в ожидающие пересчёта */
+static void bitsolver_mark(BitSolver* s, int r, int lo, int hi) {
+    lo = lo > 0 ? lo - 1 : 0;
+    hi = hi + 1 < s->words ? hi + 1 : s->words - 1;
+    for (int q = r - 2; q <= r + 2; ++q) {
+        if (q < 0 || q >= s->rows) continue;
+        if (s->pend_lo[q] > s->pend_hi[q]) { s->pend_lo[q] = lo; s->pend_hi[q] = hi; continue; }
+        if (lo < s->pend_lo[q]) s->pend_lo[q] = lo;
+        if (hi > s->pend_hi[q]) s->pend_hi[q] = hi;
+    }
+}
+
+static bool bitsolver_visit(BitSolver* s, int r) {
+    int lo = s->pend_lo[r], hi = s->pend_hi[r];
+    if (lo > hi) return false;
+    s->pend_lo[r] = s->words;
+    s->pend_hi[r] = -1;
+    int clo, chi;
+    if (!bitsolver_row(s, r, lo, hi, &clo, &chi)) return false;
+    bitsolver_mark(s, r, clo, chi);
+    return true;
+}
+
+bool bitsolver_solve(BitSolver* s, int start_r, int start_c) {
+    if (!s) return false;
+    s->opened = 0;
+    if (start_r < 0 || start_r >= s->rows || start_c < 0 || start_c >= s->cols) return false;
+    uint64_t bit = 1ULL << (start_c % 64);
+    if (BS_ROW(s, s->mine, start_r)[start_c / 64] & bit) return false;
+
+    size_t n = (size_t)s->rows * s->words;
+    memset(BS_ROW(s, s->open, 0), 0, n * sizeof(uint64_t));
+    memset(BS_ROW(s, s->flag, 0), 0, n * sizeof(uint64_t));
+    for (int r = 0; r < s->rows; ++r) {
+        s->pend_lo[r] = s->words;
+        s->pend_hi[r] = -1;
+    }
+    BS_ROW(s, s->open, start_r)[start_c / 64] |= bit;
+    bitsolver_mark(s, start_r, start_c / 64, start_c / 64);
+
+    /* проходы вниз и вверх, пока хоть одна строка меняется */
+    bool any;
+    do {
+        any = false;
+        for (int r = 0; r < s->rows; ++r) any |= bitsolver_visit(s, r);
+        for (int r = s->rows - 1; r >= 0; --r) any |= bitsolver_visit(s, r);
+    } while (any);
+
+    const uint64_t* op = BS_ROW(s, s->open, 0);
+    for (size_t i = 0; i < n; ++i) s->opened += bit_popcount64(op[i]);
+    return s->opened == (long long)s->rows * s->cols - s->mines;
+}
+
+long long bitsolver_opened(const BitSolver* s) {
+    return s ? s->opened : 0;
+}
+
+size_t bitsolver_bytes(const BitSolver* s) {
+    if (!s) return 0;
+    return sizeof(BitSolver)
+        + 3 * (size_t)(s->rows + 2 * BS_PAD) * s->words * sizeof(uint64_t)
+        + 10 * (size_t)s->words * sizeof(uint64_t)
+        + 2 * (size_t)s->rows * sizeof(int);
+}
+
+bool simulate_solver_bits(const Field* f, int start_r, int start_c) {
+    if (!f) return false;
+    BitSolver* s = bitsolver_create(f->rows, f->cols);
+    if (!s) return false;
+    bool ok = bitsolver_load(s, f) && bitsolver_solve(s, start_r, start_c);
+    bitsolver_free(s);
+    return ok;
+}
@@ -0,0 +1,63 @@
+#ifndef MINES_BITSOLVE_H
+#define MINES_BITSOLVE_H
+
+#include "bitboard.h"
+
+/* -------------------------------------------------------------------
+   Битово-параллельный солвер: те же правила A/B, что simulate_solver_ctx
+   (уровень SOLVER_BASIC), но множества открытых клеток и помеченных мин —
+   битовые плоскости в раскладке BitField, и правила применяются сразу к
+   64 клеткам слова.
+   Правила записываются через дилатацию (сдвиги слов на клетку во все 8 сторон),
+   без счётчиков в клетках:
+     - B (число == помеченные мины): у открытой клетки нет соседней
+       непомеченной мины, т.е. клетка вне dil8(mine & ~flag); тогда её
+       закрытые непомеченные соседи безопасны;
+     - A (число == помеченные + закрытые): у открытой клетки нет закрытого
+       безопасного соседа, т.е. клетка вне dil8(закрытые & ~mine); тогда её
+       закрытые непомеченные соседи — мины.
+   Условия эквивалентны сравнению чисел на клетках, поэтому открытое множество
+   в итоге то же, что у simulate_solver_ctx с SOLVER_BASIC.
+   Нулевые области — частный случай правила B; вдоль строки они заливаются
+   сразу на всю длину (заливка с препятствиями по словам, Kogge-Stone),
+   а между строками — проходами вниз и вверх только по изменившимся строкам.
+   Память: три бита на клетку (мины, открытые, помеченные) и пара чисел на строку.
+   ------------------------------------------------------------------- */
+
+typedef struct BitSolver BitSolver;
+
+/* bitsolver_create / bitsolver_free
+   - Битовые плоскости под поле rows x cols. NULL при ошибке; free безопасно с NULL.
+*/
+BitSolver* bitsolver_create(int rows, int cols);
+void bitsolver_free(BitSolver* s);
+
+/* bitsolver_load / bitsolver_load_bits
+   - Загружает расстановку мин: из f->is_mine или из битового поля (например,
+     поле корпуса corpus_board — без материализации Field). Размеры должны совпадать.
+*/
+bool bitsolver_load(BitSolver* s, const Field* f);
+bool bitsolver_load_bits(BitSolver* s, const BitField* mines);
+
+/* bitsolver_solve
+   - Решение из стартовой клетки (как simulate_solver_ctx с SOLVER_BASIC).
+   - true — открыты все безопасные клетки загруженного поля.
+*/
+bool bitsolver_solve(BitSolver* s, int start_r, int start_c);
+
+/* bitsolver_opened
+   - Сколько клеток открыто последним bitsolver_solve.
+*/
+long long bitsolver_opened(const BitSolver* s);
+
+/* bitsolver_bytes
+   - Объём рабочей памяти солвера в байтах (для сравнения с SolverCtx).
+*/
+size_t bitsolver_bytes(const BitSolver* s);
+
+/* simulate_solver_bits
+   - Вариант без переиспользования: создаёт BitSolver на один вызов.
+*/
+bool simulate_solver_bits(const Field* f, int start_r, int start_c);
+
+#endif /* MINES_BITSOLVE_H */
@@ -0,0 +1,234 @@
+#include "calib.h"
+#include <math.h>
+
+/* Заголовок файла таблицы (первая строка; строки с '#' при чтении пропускаются) */
+#define CALIB_HEADER "# mines calibration v1: rows cols percent strength first_click attempts accepted"
+
+/* Корзина таблицы */
+typedef struct {
+    int rows, cols, percent;
+    int strength;
+    int first_click;
+    long long attempts, accepted;
+} CalibEntry;
+
+struct CalibTable {
+    CalibEntry* items;
+    int count, cap;
+};
+
+/* Одна ли у корзин конфигурация без учёта плотности */
+static bool calib_same_class(const CalibEntry* e, int rows, int cols, int strength, int first_click) {
+    return e->rows == rows && e->cols == cols && e->strength == strength && e->first_click == first_click;
+}
+
+static CalibEntry* calib_find(const CalibTable* t, int rows, int cols, int percent, int strength, int first_click) {
+    for (int i = 0; i < t->count; ++i) {
+        CalibEntry* e = &t->items[i];
+        if (calib_same_class(e, rows, cols, strength, first_click) && e->percent == percent) return e;
+    }
+    return NULL;
+}
+
+/* Находит или заводит корзину; NULL при нехватке памяти */
+static CalibEntry* calib_entry(CalibTable* t, int rows, int cols, int percent, int strength, int first_click) {
+    CalibEntry* e = calib_find(t, rows, cols, percent, strength, first_click);
+    if (e) return e;
+    if (t->count == t->cap) {
+        int cap = t->cap ? t->cap * 2 : 32;
+        CalibEntry* p = (CalibEntry*)realloc(t->items, (size_t)cap * sizeof(CalibEntry));
+        if (!p) return NULL;
+        t->items = p;
+        t->cap = cap;
+    }
+    e = &t->items[t->count++];
+    memset(e, 0, sizeof *e);
+    e->rows = rows;
+    e->cols = cols;
+    e->percent = percent;
+    e->strength = strength;
+    e->first_click = first_click;
+    return e;
+}
+
+CalibTable* calib_load(const char* path) {
+    CalibTable* t = (CalibTable*)calloc(1, sizeof(CalibTable));
+    if (!t || !path) return t;
+    FILE* in = fopen(path, "r");
+    if (!in) return t; /* файла ещё нет — пустая таблица */
+
+    char line[256];
+    while (fgets(line, sizeof line, in)) {
+        if (line[0] == '#') continue;
+        CalibEntry e;
+        if (sscanf(line, "%d %d %d %d %d %lld %lld", &e.rows, &e.cols, &e.percent, &e.strength,
+                &e.first_click, &e.attempts, &e.accepted) != 7) continue;
+        if (e.rows <= 0 || e.cols <= 0 || e.percent < 0 || e.percent > 100 || e.attempts < 0
+            || e.accepted < 0 || e.accepted > e.attempts) continue;
+        CalibEntry* dst = calib_entry(t, e.rows, e.cols, e.percent, e.strength, e.first_click != 0);
+        if (!dst) break;
+        dst->attempts += e.attempts;
+        dst->accepted += e.accepted;
+    }
+    fclose(in);
+    return t;
+}
+
+bool calib_save(const CalibTable* t, const char* path) {
+    if (!t || !path) return false;
+    char tmp[1024];
+    if (snprintf(tmp, sizeof tmp, "%s.tmp", path) >= (int)sizeof tmp) return false;
+    FILE* out = fopen(tmp, "w");
+    if (!out) return false;
+
+    bool ok = fprintf(out, "%s\n", CALIB_HEADER) > 0;
+    for (int i = 0; i < t->count && ok; ++i) {
+        const CalibEntry* e = &t->items[i];
+        ok = fprintf(out, "%d %d %d %d %d %lld %lld\n", e->rows, e->cols, e->percent, e->strength,
+            e->first_click, e->attempts, e->accepted) > 0;
+    }
+    if (fclose(out) != 0) ok = false;
+#ifdef _WIN32
+    /* rename в Windows не заменяет существующий файл */
+    if (ok) remove(path);
+#endif
+    if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        return false;
+    }
+    return true;
+}
+
+void calib_free(CalibTable* t) {
+    if (!t) return;
+    free(t->items);
+    free(t);
+}
+
+int calib_percent(int rows, int cols, int percent, int mines) {
+    if (mines < 0) return percent;
+    long long cells = (long long)rows * cols;
+    if (cells <= 0) return 0;
+    long long p = ((long long)mines * 100 + cells / 2) / cells;
+    return p > 100 ? 100 : (int)p;
+}
+
+void calib_record(CalibTable* t, int rows, int cols, int percent, SolverStrength strength,
+    bool first_click, long long attempts, long long accepted) {
+    if (!t || attempts <= 0) return;
+    CalibEntry* e = calib_entry(t, rows, cols, percent, (int)strength, first_click);
+    if (!e) return;
+    e->attempts += attempts;
+    e->accepted += accepted < 0 ? 0 : accepted > attempts ? attempts : accepted;
+}
+
+long long calib_trials(const GenResult* res) {
+    if (!res->solvable) return res->attempts_made;
+    /* прерванный по сроку запуск мог не доиграть меньшие номера */
+    long long upto = (long long)res->attempt + 1;
+    return upto < res->attempts_made ? upto : res->attempts_made;
+}
+
+/* Шанс хотя бы одного успеха за n попыток при доле p */
+static double calib_chance(double p, int n) {
+    if (p <= 0) return 0;
+    if (p >= 1) return 1;
+    return -expm1(n * log1p(-p));
+}
+
+/* Верхняя 95%-я оценка доли при accepted успехах из attempts (приближение Пуассона) */
+static double calib_upper(long long accepted, long long attempts) {
+    double s = (double)accepted;
+    double u = (s + 2 * sqrt(s) + 3) / (double)attempts;
+    return u > 1 ? 1 : u;
+}
+
+/* Корзины класса с плотностью не выше percent, по убыванию плотности */
+static int calib_lower(const CalibTable* t, int rows, int cols, int percent, int strength, int first_click,
+    const CalibEntry** out) {
+    int n = 0;
+    for (int i = 0; i < t->count; ++i) {
+        const CalibEntry* e = &t->items[i];
+        if (!calib_same_class(e, rows, cols, strength, first_click) || e->percent > percent || e->attempts == 0)
+            continue;
+        int k = n++;
+        while (k > 0 && out[k - 1]->percent < e->percent) { out[k] = out[k - 1]; --k; }
+        out[k] = e;
+    }
+    return n;
+}
+
+CalibVerdict calib_plan(const CalibTable* t, int rows, int cols, int percent, SolverStrength strength,
+    bool first_click, int max_attempts, CalibPlan* plan) {
+    plan->verdict = CALIB_UNKNOWN;
+    plan->attempts = max_attempts;
+    plan->rate = -1;
+    plan->expected = -1;
+    plan->samples = 0;
+    plan->suggest_percent = -1;
+    if (!t || t->count == 0) return plan->verdict;
+
+    const CalibEntry** lower = (const CalibEntry**)malloc((size_t)t->count * sizeof(CalibEntry*));
+    if (!lower) return plan->verdict;
+    int fc = first_click ? 1 : 0;
+    int n = calib_lower(t, rows, cols, percent, (int)strength, fc, lower);
+
+    const CalibEntry* own = n > 0 && lower[0]->percent == percent ? lower[0] : NULL;
+    if (own) {
+        plan->samples = (uint64_t)own->attempts;
+        plan->rate = (double)own->accepted / (double)own->attempts;
+        if (own->accepted > 0) plan->expected = 1.0 / plan->rate;
+    }
+
+    /* верхняя оценка доли: своя корзина и все меньшие плотности вместе с ней */
+    double upper = 1;
+    long long s = 0, a = 0;
+    for (int i = 0; i < n; ++i) {
+        s += lower[i]->accepted;
+        a += lower[i]->attempts;
+        double u = calib_upper(s, a);
+        if (u < upper) upper = u;
+    }
+
+    /* ближайшая меньшая плотность, на которой поле почти наверняка находится */
+    for (int i = 0; i < n; ++i) {
+        const CalibEntry* e = lower[i];
+        if (e->percent == percent || e->accepted == 0) continue;
+        if (calib_chance((double)e->accepted / (double)e->attempts, max_attempts) >= 1 - CALIB_MIN_CHANCE) {
+            plan->suggest_percent = e->percent;
+            break;
+        }
+    }
+    free(lower);
+
+    if (n > 0 && calib_chance(upper, max_attempts) < CALIB_MIN_CHANCE) {
+        plan->verdict = CALIB_INFEASIBLE;
+        plan->attempts = 0;
+    }
+    else if (own && own->accepted >= CALIB_MIN_HITS) {
+        /* попыток столько, чтобы промах был не вероятнее CALIB_MISS */
+        double need = plan->rate >= 1 ? 1 : ceil(log(CALIB_MISS) / log1p(-plan->rate));
+        plan->verdict = CALIB_FEASIBLE;
+        if (need < CALIB_MIN_BUDGET) need = CALIB_MIN_BUDGET;
+        plan->attempts = need >= max_attempts ? max_attempts : (int)need;
+    }
+    return plan->verdict;
+}
+
+void calib_print_plan(const CalibPlan* plan, int percent, FILE* out) {
+    if (plan->verdict == CALIB_UNKNOWN && plan->samples == 0) {
+        fprintf(out, "Калибровка: для %d%% данных нет, попыток до %d.\n", percent, plan->attempts);
+        return;
+    }
+    fprintf(out, "Калибровка: %d%% — ", percent);
+    if (plan->samples > 0)
+        fprintf(out, "решаемых %.4g%% из %llu попыток", plan->rate * 100, (unsigned long long)plan->samples);
+    else fprintf(out, "своих данных нет");
+    if (plan->expected > 0) fprintf(out, ", ожидается %.1f попыток на поле", plan->expected);
+    if (plan->verdict == CALIB_INFEASIBLE) {
+        fprintf(out, ". Решаемое поле практически не найти");
+        if (plan->suggest_percent >= 0) fprintf(out, "; ближайшая плотность с решаемыми полями: %d%%", plan->suggest_percent);
+        fprintf(out, ".\n");
+    }
+    else fprintf(out, ", попыток до %d.\n", plan->attempts);
+}
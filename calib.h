@@ -0,0 +1,104 @@
+#ifndef MINES_CALIB_H
+#define MINES_CALIB_H
+
+#include "field.h"
+#include "generator.h"
+#include <stdint.h>
+
+/* -------------------------------------------------------------------
+   Калибровка: наблюдаемая доля решаемых попыток по конфигурациям.
+   Корзина — (rows, cols, процент мин, уровень солвера, первый клик); в ней
+   копятся попытки и принятые поля всех запусков. Таблица хранится на диске
+   текстом (строка на корзину) и по ней до генерации решается:
+     - сколько попыток дать (бюджет): столько, чтобы при наблюдаемой доле
+       поле не нашлось лишь с вероятностью CALIB_MISS, но не больше max_attempts;
+     - не безнадёжна ли конфигурация: если даже по верхней 95%-й оценке доли
+       шанс найти поле за max_attempts попыток ниже CALIB_MIN_CHANCE, генерация
+       не запускается, а предлагается ближайшая меньшая плотность, на которой
+       поля находились.
+   Доля решаемых не растёт с плотностью, поэтому неудачи на меньших
+   плотностях того же размера учитываются и для больших.
+   Режим точного числа мин попадает в корзину округлённого процента.
+   Таблица не потокобезопасна: общий экземпляр защищает вызывающий.
+   ------------------------------------------------------------------- */
+
+/* Допустимая вероятность не найти поле за бюджет при известной доле */
+#define CALIB_MISS 0.001
+
+/* Ниже этого шанса (по верхней оценке доли) конфигурация считается безнадёжной */
+#define CALIB_MIN_CHANCE 0.25
+
+/* Принятых полей в корзине, после которых её доле доверяют для бюджета */
+#define CALIB_MIN_HITS 10
+
+/* Нижняя граница бюджета: на маленькой выборке доля бывает завышена */
+#define CALIB_MIN_BUDGET 32
+
+typedef struct CalibTable CalibTable;
+
+/* Вердикт калибровки для конфигурации */
+typedef enum {
+    CALIB_UNKNOWN,          /* данных мало: бюджет max_attempts */
+    CALIB_FEASIBLE,         /* доля известна: бюджет по ней */
+    CALIB_INFEASIBLE        /* поле практически не найти: не запускать */
+} CalibVerdict;
+
+/* План генерации */
+typedef struct {
+    CalibVerdict verdict;
+    int attempts;           /* бюджет попыток на одно поле (0 при CALIB_INFEASIBLE) */
+    double rate;            /* наблюдаемая доля решаемых (-1 — попыток не было) */
+    double expected;        /* ожидаемое число попыток на поле (-1 — неизвестно) */
+    uint64_t samples;       /* попыток в корзине */
+    int suggest_percent;    /* ближайшая меньшая плотность, где поля находятся (-1 — нет данных) */
+} CalibPlan;
+
+/* calib_load
+   - Читает таблицу из path; нет файла — пустая таблица, строки с ошибками пропускаются.
+   - path == NULL — пустая таблица без файла. Возвращает NULL только при нехватке памяти.
+*/
+CalibTable* calib_load(const char* path);
+
+/* calib_save
+   - Записывает таблицу во временный файл рядом с path и переименовывает его в path,
+     так что прерванная запись не портит прежнюю таблицу.
+*/
+bool calib_save(const CalibTable* t, const char* path);
+
+/* calib_free
+   - Освобождает таблицу. Безопасно вызывать с NULL.
+*/
+void calib_free(CalibTable* t);
+
+/* calib_percent
+   - Процент корзины: percent, а при mines >= 0 — округлённая доля mines на поле rows x cols.
+*/
+int calib_percent(int rows, int cols, int percent, int mines);
+
+/* calib_record
+   - Добавляет в корзину attempts попыток, из которых accepted дали решаемое поле.
+*/
+void calib_record(CalibTable* t, int rows, int cols, int percent, SolverStrength strength,
+    bool first_click, long long attempts, long long accepted);
+
+/* calib_trials
+   - Сколько попыток запуска ParGen учитывать в calib_record: при успехе — попытки
+     с номерами до принятой включительно (попытки с большими номерами, начатые
+     другими потоками до отмены, не неудачи, и их число зависит от числа ядер),
+     иначе — все выполненные попытки.
+*/
+long long calib_trials(const GenResult* res);
+
+/* calib_plan
+   - План для конфигурации при наибольшем бюджете max_attempts; возвращает plan->verdict.
+   - t == NULL — всегда CALIB_UNKNOWN с бюджетом max_attempts.
+*/
+CalibVerdict calib_plan(const CalibTable* t, int rows, int cols, int percent, SolverStrength strength,
+    bool first_click, int max_attempts, CalibPlan* plan);
+
+/* calib_print_plan
+   - Строка о плане для пользователя (доля, ожидаемые попытки, подсказка плотности).
+*/
+void calib_print_plan(const CalibPlan* plan, int percent, FILE* out);
+
+#endif /* MINES_CALIB_H */
@@ -0,0 +1,243 @@
+#include "corpus.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct CorpusWriter {
+    FILE* out;
+    uint64_t pos;           /* текущее смещение в файле */
+    uint64_t* index;        /* смещения записанных полей */
+    uint64_t count, cap;
+    BitField* scratch;      /* буфер упаковки под размер последнего поля */
+    bool ok;
+};
+
+struct Corpus {
+    const unsigned char* base;
+    uint64_t size;
+    uint64_t count;
+    const uint64_t* index;
+    unsigned char* bad;     /* по биту на запись: повреждена (проверено в corpus_open) */
+#ifdef _WIN32
+    HANDLE file, mapping;
+#endif
+};
+
+/* Запись блока с учётом смещения; ошибка запоминается до закрытия */
+static void corpus_put(CorpusWriter* w, const void* p, size_t n) {
+    if (w->ok && fwrite(p, 1, n, w->out) != n) w->ok = false;
+    w->pos += n;
+}
+
+CorpusWriter* corpus_writer_open(const char* path) {
+    CorpusWriter* w = (CorpusWriter*)calloc(1, sizeof(CorpusWriter));
+    if (!w) return NULL;
+    w->out = fopen(path, "wb");
+    if (!w->out) { free(w); return NULL; }
+    setvbuf(w->out, NULL, _IOFBF, 1 << 20);
+    w->ok = true;
+
+    /* заголовок-заглушка: число полей и индекс станут известны при закрытии */
+    CorpusHeader h;
+    memset(&h, 0, sizeof h);
+    corpus_put(w, &h, sizeof h);
+    return w;
+}
+
+bool corpus_writer_add(CorpusWriter* w, const Field* f, const CorpusMeta* meta) {
+    if (!w || !f || !w->ok) return false;
+
+    if (!w->scratch || w->scratch->rows != f->rows || w->scratch->cols != f->cols) {
+        bitfield_free(w->scratch);
+        w->scratch = bitfield_create(f->rows, f->cols);
+        if (!w->scratch) { w->ok = false; return false; }
+    }
+    if (w->count == w->cap) {
+        uint64_t cap = w->cap ? w->cap * 2 : 1024;
+        uint64_t* idx = (uint64_t*)realloc(w->index, (size_t)cap * sizeof(uint64_t));
+        if (!idx) { w->ok = false; return false; }
+        w->index = idx;
+        w->cap = cap;
+    }
+    w->index[w->count++] = w->pos;
+
+    CorpusRecord rec;
+    memset(&rec, 0, sizeof rec);
+    rec.rows = (uint32_t)f->rows;
+    rec.cols = (uint32_t)f->cols;
+    rec.mines = (uint32_t)f->mines;
+    if (meta) {
+        rec.flags = meta->flags;
+        rec.seed = meta->seed;
+        rec.start_r = meta->start_r;
+        rec.start_c = meta->start_c;
+    }
+    bitfield_from_field(w->scratch, f);
+    corpus_put(w, &rec, sizeof rec);
+    corpus_put(w, w->scratch->bits, (size_t)f->rows * w->scratch->words * sizeof(uint64_t));
+    return w->ok;
+}
+
+bool corpus_writer_close(CorpusWriter* w) {
+    if (!w) return false;
+    CorpusHeader h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, CORPUS_MAGIC, sizeof h.magic);
+    h.version = CORPUS_VERSION;
+    h.header_size = sizeof(CorpusHeader);
+    h.count = w->count;
+    h.index_offset = w->pos;
+
+    if (w->count) corpus_put(w, w->index, (size_t)w->count * sizeof(uint64_t));
+    if (w->ok && (fseek(w->out, 0, SEEK_SET) != 0 || fwrite(&h, sizeof h, 1, w->out) != 1)) w->ok = false;
+    if (fclose(w->out) != 0) w->ok = false;
+
+    bool ok = w->ok;
+    bitfield_free(w->scratch);
+    free(w->index);
+    free(w);
+    return ok;
+}
+
+/* ---------- Отображение файла в память ---------- */
+
+static void corpus_unmap(Corpus* c) {
+#ifdef _WIN32
+    if (c->base) UnmapViewOfFile(c->base);
+    if (c->mapping) CloseHandle(c->mapping);
+    if (c->file && c->file != INVALID_HANDLE_VALUE) CloseHandle(c->file);
+#else
+    if (c->base) munmap((void*)c->base, (size_t)c->size);
+#endif
+}
+
+static bool corpus_map(Corpus* c, const char* path) {
+#ifdef _WIN32
+    c->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (c->file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(c->file, &sz) || sz.QuadPart < (LONGLONG)sizeof(CorpusHeader)) return false;
+    c->size = (uint64_t)sz.QuadPart;
+    c->mapping = CreateFileMappingA(c->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!c->mapping) return false;
+    c->base = (const unsigned char*)MapViewOfFile(c->mapping, FILE_MAP_READ, 0, 0, 0);
+    return c->base != NULL;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CorpusHeader)) { close(fd); return false; }
+    c->size = (uint64_t)st.st_size;
+    void* p = mmap(NULL, (size_t)c->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); /* отображение остаётся действительным и после закрытия дескриптора */
+    if (p == MAP_FAILED) return false;
+    c->base = (const unsigned char*)p;
+    return true;
+#endif
+}
+
+/* Плоскость мин записи: биты за cols нулевые, а единиц ровно mines */
+static bool corpus_bits_valid(const uint64_t* bits, int rows, int cols, int words, uint32_t mines) {
+    uint64_t tail = cols % 64 ? ~0ULL << (cols % 64) : 0;
+    uint64_t total = 0;
+    for (int r = 0; r < rows; ++r) {
+        const uint64_t* row = bits + (size_t)r * words;
+        if (row[words - 1] & tail) return false;
+        for (int w = 0; w < words; ++w) total += (uint64_t)bit_popcount64(row[w]);
+    }
+    return total == mines;
+}
+
+/* Запись номер k без проверки плоскости мин: лежит ли она в файле и допустимы ли размеры */
+static bool corpus_record(const Corpus* c, uint64_t k, CorpusBoard* b) {
+    uint64_t ofs = c->index[k];
+    if (ofs % 8 != 0 || ofs > c->size || c->size - ofs < sizeof(CorpusRecord)) return false;
+
+    const CorpusRecord* rec = (const CorpusRecord*)(c->base + ofs);
+    if (rec->rows == 0 || rec->cols == 0 || rec->rows > INT32_MAX || rec->cols > INT32_MAX
+        || rec->mines > INT32_MAX) return false;
+    int words = (int)((rec->cols + 63) / 64);
+    uint64_t plane = (uint64_t)rec->rows * (uint64_t)words * sizeof(uint64_t);
+    if (c->size - ofs - sizeof(CorpusRecord) < plane) return false;
+
+    const uint64_t* bits = (const uint64_t*)(c->base + ofs + sizeof(CorpusRecord));
+    b->rows = (int)rec->rows;
+    b->cols = (int)rec->cols;
+    b->mines = (int)rec->mines;
+    b->meta.flags = rec->flags;
+    b->meta.seed = rec->seed;
+    b->meta.start_r = rec->start_r;
+    b->meta.start_c = rec->start_c;
+    b->words = words;
+    b->mine_bits = bits;
+    return true;
+}
+
+Corpus* corpus_open(const char* path) {
+    if (!path) return NULL;
+    Corpus* c = (Corpus*)calloc(1, sizeof(Corpus));
+    if (!c) return NULL;
+    if (!corpus_map(c, path)) { corpus_close(c); return NULL; }
+
+    const CorpusHeader* h = (const CorpusHeader*)c->base;
+    bool valid = memcmp(h->magic, CORPUS_MAGIC, sizeof h->magic) == 0
+        && h->version == CORPUS_VERSION
+        && h->header_size == sizeof(CorpusHeader)
+        && h->index_offset % 8 == 0
+        && h->index_offset <= c->size
+        && h->count <= (c->size - h->index_offset) / sizeof(uint64_t);
+    if (!valid) { corpus_close(c); return NULL; }
+
+    c->count = h->count;
+    c->index = (const uint64_t*)(c->base + h->index_offset);
+
+    /* записи проверяются один раз здесь, чтобы доступ к полю оставался O(1) */
+    c->bad = (unsigned char*)calloc((size_t)(c->count / 8 + 1), 1);
+    if (!c->bad) { corpus_close(c); return NULL; }
+    for (uint64_t k = 0; k < c->count; ++k) {
+        CorpusBoard b;
+        if (!corpus_record(c, k, &b)
+            || !corpus_bits_valid(b.mine_bits, b.rows, b.cols, b.words, (uint32_t)b.mines))
+            c->bad[k >> 3] |= (unsigned char)(1u << (k & 7));
+    }
+    return c;
+}
+
+void corpus_close(Corpus* c) {
+    if (!c) return;
+    corpus_unmap(c);
+    free(c->bad);
+    free(c);
+}
+
+uint64_t corpus_count(const Corpus* c) { return c ? c->count : 0; }
+
+bool corpus_board(const Corpus* c, uint64_t k, CorpusBoard* b) {
+    if (!c || !b || k >= c->count || (c->bad[k >> 3] >> (k & 7)) & 1u) return false;
+    return corpus_record(c, k, b);
+}
+
+bool corpus_load(const Corpus* c, uint64_t k, Field* f) {
+    CorpusBoard b;
+    if (!f || !corpus_board(c, k, &b)) return false;
+    if (b.rows != f->rows || b.cols != f->cols) return false;
+    for (int r = 0; r < b.rows; ++r) {
+        const uint64_t* row = b.mine_bits + (size_t)r * b.words;
+        unsigned char* out = &f->is_mine[IDX(f, r, 0)];
+        for (int col = 0; col < b.cols; ++col)
+            out[col] = (unsigned char)((row[col >> 6] >> (col & 63)) & 1u);
+    }
+    f->mines = b.mines;
+    compute_counts(f);
+    return true;
+}
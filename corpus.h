@@ -0,0 +1,110 @@
+#ifndef MINES_CORPUS_H
+#define MINES_CORPUS_H
+
+#include "bitboard.h"
+
+/* -------------------------------------------------------------------
+   Двоичный корпус полей: много полей в одном файле.
+   Формат (little-endian, все блоки выровнены на 8 байт):
+     - заголовок CorpusHeader (64 байта): сигнатура, версия, число полей,
+       смещение индекса;
+     - записи полей: CorpusRecord (32 байта) и сразу за ним плоскость мин
+       rows * words 64-битных слов в раскладке BitField (1 бит на клетку);
+     - индекс: count 64-битных смещений записей от начала файла.
+   Счётчики не хранятся — они однозначно восстанавливаются по минам
+   при загрузке, поэтому поле занимает примерно в 8 раз меньше, чем текст.
+   Читатель отображает файл в память (mmap / CreateFileMapping) и один раз
+   при открытии проверяет все записи, так что доступ к полю номер k — O(1)
+   и без копирования.
+   ------------------------------------------------------------------- */
+
+#define CORPUS_MAGIC "MSWCORP1"
+#define CORPUS_VERSION 1
+
+/* Флаги записи: какие метаданные заданы */
+#define CORPUS_HAS_SEED  1u  /* seed — зерно, из которого построено поле */
+#define CORPUS_HAS_START 2u  /* start_r, start_c — стартовая клетка солвера */
+
+typedef struct {
+    char magic[8];          /* CORPUS_MAGIC без завершающего нуля */
+    uint32_t version;
+    uint32_t header_size;   /* sizeof(CorpusHeader) */
+    uint64_t count;         /* число полей */
+    uint64_t index_offset;  /* смещение индекса от начала файла */
+    uint8_t reserved[32];
+} CorpusHeader;
+
+typedef struct {
+    uint32_t rows, cols;
+    uint32_t mines;
+    uint32_t flags;         /* CORPUS_HAS_* */
+    uint64_t seed;
+    int32_t start_r, start_c;
+} CorpusRecord;
+
+/* Метаданные поля при записи (NULL — без метаданных) */
+typedef struct {
+    uint32_t flags;         /* CORPUS_HAS_* */
+    uint64_t seed;
+    int start_r, start_c;
+} CorpusMeta;
+
+/* Поле корпуса без копирования: mine_bits указывает в отображённый файл
+   и доступно только для чтения, пока корпус открыт. Раскладка битов как у
+   BitField: строка r — words слов с mine_bits[r * words], биты за cols равны 0 */
+typedef struct {
+    int rows, cols, mines;
+    CorpusMeta meta;
+    int words;
+    const uint64_t* mine_bits;
+} CorpusBoard;
+
+typedef struct CorpusWriter CorpusWriter;
+typedef struct Corpus Corpus;
+
+/* corpus_writer_open
+   - Создаёт файл корпуса (перезаписывая существующий). Возвращает NULL при ошибке.
+*/
+CorpusWriter* corpus_writer_open(const char* path);
+
+/* corpus_writer_add
+   - Дописывает поле: упаковывает мины в биты, счётчики не сохраняются.
+   - Поля в одном корпусе могут быть разного размера.
+*/
+bool corpus_writer_add(CorpusWriter* w, const Field* f, const CorpusMeta* meta);
+
+/* corpus_writer_close
+   - Записывает индекс и окончательный заголовок, закрывает файл и освобождает w.
+   - Возвращает false, если какая-либо запись не удалась (файл тогда неполон).
+*/
+bool corpus_writer_close(CorpusWriter* w);
+
+/* corpus_open / corpus_close
+   - Отображает файл корпуса в память и проверяет заголовок и индекс.
+   - Проверяет каждую запись одним проходом по файлу: запись и плоскость мин лежат
+     в файле, биты за cols в последнем слове строки — нули, единичных битов ровно
+     mines. Повреждённые записи запоминаются (бит на запись) и не выдаются.
+   - Возвращает NULL, если файл не открыт или не является корпусом.
+*/
+Corpus* corpus_open(const char* path);
+void corpus_close(Corpus* c);
+
+/* corpus_count
+   - Число полей в корпусе.
+*/
+uint64_t corpus_count(const Corpus* c);
+
+/* corpus_board
+   - Заполняет b видом на поле номер k без копирования данных.
+   - Возвращает false, если k вне корпуса или запись повреждена (см. corpus_open).
+     O(1): плоскость мин здесь не читается.
+*/
+bool corpus_board(const Corpus* c, uint64_t k, CorpusBoard* b);
+
+/* corpus_load
+   - Материализует поле номер k в f (размеры должны совпадать): распаковывает
+     мины и только здесь считает счётчики (compute_counts).
+*/
+bool corpus_load(const Corpus* c, uint64_t k, Field* f);
+
+#endif /* MINES_CORPUS_H */
@@ -1,162 +1,299 @@
 #include "field.h"
+#include "render.h"
+#include "parfield.h"
+#include "fixedsize.h"
+#include "mt.h"
+#include <limits.h>
+#include <stdint.h>
 #include <time.h>
 
+/*        (0,0)   */
+#define FIELD_BUF_SIZE(f) ((size_t)((f)->rows + 2) * (f)->stride)
+#define FIELD_BUF_OFS(f) ((f)->stride + 1)
+
+/*      f (fixedsize.h)  NULL */
+#ifdef FIELD_NO_FIXED
+#define FIELD_FIXED(f) ((const FixedKernels*)NULL)
+#else
+#define FIELD_FIXED(f) fixed_kernels((f)->rows, (f)->cols)
+#endif
+
+/*  : is_mine = 0 (    ), count = FIELD_BORDER */
+static void field_init_border(Field* f) {
+    int R = f->rows, C = f->cols;
+    memset(f->count - FIELD_BUF_OFS(f), FIELD_BORDER, f->stride);
+    memset(f->count + IDX(f, R, -1), FIELD_BORDER, f->stride);
+    for (int r = 0; r < R; ++r) {
+        f->count[IDX(f, r, -1)] = FIELD_BORDER;
+        f->count[IDX(f, r, C)] = FIELD_BORDER;
+    }
+}
+
    /*  ,   */
 Field* field_create(int rows, int cols) {
-    if (rows <= 0 || cols <= 0) return NULL;
+    if (rows <= 0 || cols <= 0 || cols > INT_MAX - 2 || rows > INT_MAX - 2) return NULL;
+    /*     size_t;  32-      */
+    if ((size_t)rows + 2 > SIZE_MAX / ((size_t)cols + 2)) return NULL;
     Field* f = (Field*)malloc(sizeof(Field));
     if (!f) return NULL;
 
     f->rows = rows;
     f->cols = cols;
     f->mines = 0;
-    int n = rows * cols;
-    f->is_mine = (unsigned char*)calloc(n, sizeof(unsigned char));
-    f->count = (unsigned char*)calloc(n, sizeof(unsigned char));
-    if (!f->is_mine || !f->count) {
-        free(f->is_mine);
-        free(f->count);
+    f->stride = cols + 2;
+
+    /*   8     */
+    int k = 0;
+    for (int dr = -1; dr <= 1; ++dr)
+        for (int dc = -1; dc <= 1; ++dc)
+            if (dr != 0 || dc != 0) f->nbr[k++] = dr * f->stride + dc;
+
+    size_t n = FIELD_BUF_SIZE(f);
+    unsigned char* mine_buf = (unsigned char*)calloc(n, sizeof(unsigned char));
+    unsigned char* count_buf = (unsigned char*)calloc(n, sizeof(unsigned char));
+    if (!mine_buf || !count_buf) {
+        free(mine_buf);
+        free(count_buf);
         free(f);
         return NULL;
     }
+    f->is_mine = mine_buf + FIELD_BUF_OFS(f);
+    f->count = count_buf + FIELD_BUF_OFS(f);
+    field_init_border(f);
     return f;
 }
 
 /*   */
 void field_free(Field* f) {
     if (!f) return;
-    free(f->is_mine);
-    free(f->count);
+    free(f->is_mine - FIELD_BUF_OFS(f));
+    free(f->count - FIELD_BUF_OFS(f));
     free(f);
 }
 
-/*    */
+/*  :  count      */
 void field_clear(Field* f) {
     if (!f) return;
-    int n = f->rows * f->cols;
-    memset(f->is_mine, 0, n * sizeof(unsigned char));
-    memset(f->count, 0, n * sizeof(unsigned char));
+    size_t n = FIELD_BUF_SIZE(f);
+    memset(f->is_mine - FIELD_BUF_OFS(f), 0, n * sizeof(unsigned char));
+    memset(f->count - FIELD_BUF_OFS(f), 0, n * sizeof(unsigned char));
+    field_init_border(f);
     f->mines = 0;
 }
 
-/*     */
+/*  :    ,       */
+bool field_copy(Field* dst, const Field* src) {
+    if (!dst || !src || dst->rows != src->rows || dst->cols != src->cols) return false;
+    size_t n = FIELD_BUF_SIZE(src);
+    memcpy(dst->is_mine - FIELD_BUF_OFS(dst), src->is_mine - FIELD_BUF_OFS(src), n);
+    memcpy(dst->count - FIELD_BUF_OFS(dst), src->count - FIELD_BUF_OFS(src), n);
+    dst->mines = src->mines;
+    return true;
+}
+
+/*    :    
+         (    fixedsize.h) */
 void compute_counts(Field* f) {
     if (!f) return;
-    int R = f->rows, C = f->cols;
+    const FixedKernels* fk = FIELD_FIXED(f);
+    if (fk) { fk->compute_counts(f); return; }
+    compute_counts_rows(f, 0, f->rows);
+}
 
-    for (int r = 0; r < R; ++r) {
+/*   :   is_mine (   ),
+     count        */
+void compute_counts_rows(Field* f, int r0, int r1) {
+    if (!f) return;
+    if (r0 < 0) r0 = 0;
+    if (r1 > f->rows) r1 = f->rows;
+    int C = f->cols;
+    const int* nb = f->nbr;
+
+    for (int r = r0; r < r1; ++r) {
+        const unsigned char* m = f->is_mine + IDX(f, r, 0);
+        unsigned char* out = f->count + IDX(f, r, 0);
         for (int c = 0; c < C; ++c) {
-            int i = IDX(f, r, c);
-            if (f->is_mine[i]) { f->count[i] = 0; continue; }
-
-            int cnt = 0;
-            for (int dr = -1; dr <= 1; ++dr)
-                for (int dc = -1; dc <= 1; ++dc) {
-                    if (dr == 0 && dc == 0) continue;
-                    int rr = r + dr, cc = c + dc;
-                    if (rr >= 0 && rr < R && cc >= 0 && cc < C)
-                        if (f->is_mine[IDX(f, rr, cc)]) ++cnt;
-                }
-            f->count[i] = (unsigned char)cnt;
+            int cnt = m[c + nb[0]] + m[c + nb[1]] + m[c + nb[2]] + m[c + nb[3]]
+                + m[c + nb[4]] + m[c + nb[5]] + m[c + nb[6]] + m[c + nb[7]];
+            out[c] = m[c] ? 0 : (unsigned char)cnt;
         }
     }
 }
 
-/*    */
+/*   :  rand()     ,
+    srand() -  ,      Rng */
 void generate_by_probability(Field* f, int percent) {
     if (!f) return;
+    Rng g;
+    rng_seed(&g, ((uint64_t)rand() << 32) ^ (uint64_t)rand());
+    generate_by_probability_rng(f, percent, &g);
+}
+
+/*      .
+    64-    32- ,  
+     (      ). */
+void generate_by_probability_rng(Field* f, int percent, Rng* g) {
+    if (!f || !g) return;
+    place_by_probability_rng(f, percent, g);
+    compute_counts(f);
+}
+
+void place_by_probability_rng(Field* f, int percent, Rng* g) {
+    if (!f || !g) return;
     if (percent < 0) percent = 0;
     if (percent > 100) percent = 100;
 
     field_clear(f);
     int R = f->rows, C = f->cols;
-    int placed = 0;
+    long long placed = 0;
+    uint32_t thr = rng_percent_threshold(percent);
+    unsigned char all = (percent == 100);
+    uint64_t bits = 0;
+    int left = 0;
 
     for (int r = 0; r < R; ++r)
         for (int c = 0; c < C; ++c) {
-            int i = IDX(f, r, c);
-            if ((rand() % 100) < percent) {
-                f->is_mine[i] = 1;
-                ++placed;
-            }
+            if (left == 0) { bits = rng_next(g); left = 2; }
+            unsigned char m = all | ((uint32_t)bits < thr);
+            bits >>= 32;
+            --left;
+            f->is_mine[IDX(f, r, c)] = m;
+            placed += m;
         }
-    f->mines = placed;
-    compute_counts(f);
+    f->mines = placed > INT_MAX ? INT_MAX : (int)placed;
 }
 
-/*    ASCII */
-void print_field_ascii(const Field* f, bool show_mines) {
+/*         3x3 (O(1)).
+    ,    compute_counts,  0;   
+       . */
+void field_toggle_mine(Field* f, int r, int c) {
+    if (!f || r < 0 || r >= f->rows || c < 0 || c >= f->cols) return;
+    ptrdiff_t p = IDX(f, r, c);
+    int d = f->is_mine[p] ? -1 : 1;
+    int cnt = 0;
+    f->is_mine[p] ^= 1;
+    f->mines += d;
+    for (int k = 0; k < 8; ++k) {
+        int p2 = p + f->nbr[k];
+        cnt += f->is_mine[p2];
+        if (!f->is_mine[p2] && f->count[p2] != FIELD_BORDER) f->count[p2] = (unsigned char)(f->count[p2] + d);
+    }
+    f->count[p] = f->is_mine[p] ? 0 : (unsigned char)cnt;
+}
+
+/*        () */
+bool field_move_mine(Field* f, int from_r, int from_c, int to_r, int to_c) {
+    if (!f) return false;
+    if (from_r < 0 || from_r >= f->rows || from_c < 0 || from_c >= f->cols) return false;
+    if (to_r < 0 || to_r >= f->rows || to_c < 0 || to_c >= f->cols) return false;
+    if (!FIELD_MINE(f, from_r, from_c) || FIELD_MINE(f, to_r, to_c)) return false;
+    field_toggle_mine(f, from_r, from_c);
+    field_toggle_mine(f, to_r, to_c);
+    return true;
+}
+
+/*      (   rand(),   generate_by_probability) */
+void generate_exact(Field* f, int mines) {
     if (!f) return;
-    int R = f->rows, C = f->cols;
+    Rng g;
+    rng_seed(&g, ((uint64_t)rand() << 32) ^ (uint64_t)rand());
+    generate_exact_rng(f, mines, &g);
+}
 
-    printf("+");
-    for (int c = 0; c < C; ++c) printf("---+");
-    printf("\n");
+/*     :  .
+    j = N-K .. N-1  t  [0, j];  t     j.
+      K    K ,
+             compute_counts. */
+void generate_exact_rng(Field* f, int mines, Rng* g) {
+    if (!f || !g || !FIELD_FITS_INT(f->rows, f->cols)) return;
+    int C = f->cols, N = f->rows * f->cols;
+    if (mines < 0) mines = 0;
+    if (mines > N) mines = N;
 
-    for (int r = 0; r < R; ++r) {
-        printf("|");
-        for (int c = 0; c < C; ++c) {
-            int i = IDX(f, r, c);
-            char ch;
-            if (show_mines && f->is_mine[i]) ch = '*';
-            else if (f->is_mine[i]) ch = '*';
-            else ch = (f->count[i] == 0) ? '.' : (char)('0' + f->count[i]);
-            printf(" %c |", ch);
-        }
-        printf("\n+");
-        for (int c = 0; c < C; ++c) printf("---+");
-        printf("\n");
+    field_clear(f);
+    for (int j = N - mines; j < N; ++j) {
+        int t = (int)rng_below(g, (uint32_t)j + 1);
+        if (f->is_mine[IDX(f, t / C, t % C)]) t = j;
+        field_toggle_mine(f, t / C, t % C);
     }
 }
 
+/*    ASCII */
+void print_field_ascii(const Field* f, bool show_mines) {
+    if (!f) return;
+    /*          (render.c) */
+    render_viewport(f, 0, 0, f->rows, f->cols, show_mines, stdout);
+}
+
 /*    */
 bool save_field_to_file(const Field* f, const char* fname) {
     if (!f || !fname) return false;
     FILE* out = fopen(fname, "w");
     if (!out) return false;
 
-    fprintf(out, "%d %d %d\n", f->rows, f->cols, f->mines);
+    bool ok = write_field(f, out);
+    if (fclose(out) != 0) ok = false;
+    return ok;
+}
+
+/*    :        fwrite */
+bool write_field(const Field* f, FILE* out) {
+    if (!f || !out) return false;
+    if (fprintf(out, "%d %d %d\n", f->rows, f->cols, f->mines) < 0) return false;
+    return write_field_rows(f, out);
+}
+
+bool write_field_rows(const Field* f, FILE* out) {
+    if (!f || !out) return false;
+    char* line = (char*)malloc((size_t)f->cols + 1);
+    if (!line) return false;
+
+    bool ok = true;
+    for (int r = 0; ok && r < f->rows; ++r) {
+        const unsigned char* mine = f->is_mine + IDX(f, r, 0);
+        const unsigned char* cnt = f->count + IDX(f, r, 0);
+        for (int c = 0; c < f->cols; ++c)
+            line[c] = mine[c] ? 'M' : (char)('0' + cnt[c]);
+        line[f->cols] = '\n';
+        ok = fwrite(line, 1, (size_t)f->cols + 1, out) == (size_t)f->cols + 1;
+    }
+    free(line);
+    return ok;
+}
+
+/*   */
+int validate_field_quiet(const Field* f) {
+    if (!f) return -1;
+    int errors = 0;
     for (int r = 0; r < f->rows; ++r) {
+        const unsigned char* mine = f->is_mine + IDX(f, r, 0);
+        const unsigned char* cnt = f->count + IDX(f, r, 0);
         for (int c = 0; c < f->cols; ++c) {
-            int i = IDX(f, r, c);
-            fputc(f->is_mine[i] ? 'M' : '0' + f->count[i], out);
+            if (mine[c]) continue;
+            int n = 0;
+            for (int k = 0; k < 8; ++k) n += mine[c + f->nbr[k]];
+            errors += n != cnt[c];
         }
-        fputc('\n', out);
     }
-    fclose(out);
-    return true;
+    return errors;
 }
 
-/*   */
 bool validate_field(const Field* f) {
     if (!f) return false;
-    int R = f->rows, C = f->cols;
-    bool ok = true;
 
-    for (int r = 0; r < R; ++r) {
-        for (int c = 0; c < C; ++c) {
-            int i = IDX(f, r, c);
-            if (f->is_mine[i]) continue;
-
-            int cnt = 0;
-            for (int dr = -1; dr <= 1; ++dr)
-                for (int dc = -1; dc <= 1; ++dc) {
-                    if (dr == 0 && dc == 0) continue;
-                    int rr = r + dr, cc = c + dc;
-                    if (rr >= 0 && rr < R && cc >= 0 && cc < C)
-                        if (f->is_mine[IDX(f, rr, cc)]) ++cnt;
-                }
-
-            if (cnt != f->count[i]) {
-                printf(":  (%d,%d)  count=%d,    %d\n",
-                    r, c, f->count[i], cnt);
-                ok = false;
-            }
-        }
+    /*    ;   ,     */
+    if (validate_field_quiet(f) == 0) {
+        printf(" :   .\n");
+        return true;
     }
 
-    if (ok) printf(" :   .\n");
-    return ok;
+    FieldErrors errs;
+    validate_field_mt(f, NULL, &errs, (size_t)-1);
+    for (size_t i = 0; i < errs.count; ++i)
+        printf(":  (%d,%d)  count=%d,    %d\n",
+            errs.items[i].r, errs.items[i].c, errs.items[i].have, errs.items[i].expected);
+    field_errors_free(&errs);
+    return false;
 }
 
 /* ============   ( ) ============ */
@@ -171,162 +308,675 @@ bool validate_field(const Field* f) {
                    .
        -       (     ).
                ( check_solvability).
+       -          
+          "" :       
+         ,    -  (   ).
+               ,   R*C
+           .
    */
-bool simulate_solver_from(const Field* f, int start_r, int start_c) {
-    if (!f) return false;
-    int R = f->rows, C = f->cols, N = R * C;
-
-    /* state: -1 , 0..8  */
-    int* state = (int*)malloc(N * sizeof(int));
-    if (!state) return false;
-    for (int i = 0; i < N; ++i) state[i] = -1;
-
-    /* inferred_mine:    ,     */
-    unsigned char* inferred_mine = (unsigned char*)calloc(N, sizeof(unsigned char));
-    if (!inferred_mine) { free(state); return false; }
-
-    /*         */
-    int safe_total = 0;
-    for (int i = 0; i < N; ++i) if (!f->is_mine[i]) ++safe_total;
-
-    int start_idx = IDX(f, start_r, start_c);
-    if (f->is_mine[start_idx]) { free(state); free(inferred_mine); return false; }
-
-    /*   BFS   */
-    int* queue = (int*)malloc(N * sizeof(int));
-    if (!queue) { free(state); free(inferred_mine); return false; }
-    int qh = 0, qt = 0;
-
-    /*    */
-    state[start_idx] = f->count[start_idx];
-    if (f->count[start_idx] == 0) {
-        /*       */
-        queue[qt++] = start_idx;
-        while (qh < qt) {
-            int cur = queue[qh++];
-            int rr = cur / C, cc = cur % C;
-            for (int dr = -1; dr <= 1; ++dr)
-                for (int dc = -1; dc <= 1; ++dc) {
-                    if (dr == 0 && dc == 0) continue;
-                    int r2 = rr + dr, c2 = cc + dc;
-                    if (r2 >= 0 && r2 < R && c2 >= 0 && c2 < C) {
-                        int p2 = IDX(f, r2, c2);
-                        if (f->is_mine[p2]) continue;
-                        if (state[p2] == -1) {
-                            state[p2] = f->count[p2];
-                            if (f->count[p2] == 0) queue[qt++] = p2;
-                        }
-                    }
-                }
+
+/*   (     )    */
+struct SolverOpening {
+    int start; /*     */
+    int size;  /*      */
+};
+
+/*      ;     (0,0) */
+static unsigned int* solver_marks_alloc(const SolverCtx* ctx) {
+    unsigned int* buf = (unsigned int*)calloc(ctx->cap, sizeof(unsigned int));
+    return buf ? buf + ctx->ofs : NULL;
+}
+
+static void solver_marks_free(const SolverCtx* ctx, unsigned int* marks) {
+    if (marks) free(marks - ctx->ofs);
+}
+
+static void solver_marks_clear(const SolverCtx* ctx, unsigned int* marks) {
+    memset(marks - ctx->ofs, 0, ctx->cap * sizeof(unsigned int));
+}
+
+/*     :  IDX      */
+static bool solver_ctx_fits(const SolverCtx* ctx, const Field* f) {
+    return f->cols == ctx->cols && f->rows <= ctx->rows;
+}
+
+/*    */
+SolverCtx* solver_ctx_create(int rows, int cols) {
+    if (rows <= 0 || cols <= 0 || !FIELD_FITS_INT(rows, cols)) return NULL;
+    SolverCtx* ctx = (SolverCtx*)malloc(sizeof(SolverCtx));
+    if (!ctx) return NULL;
+
+    /*           , 
+       is_mine/count (IDX),      (0,0) */
+    int n = rows * cols;
+    ctx->rows = rows;
+    ctx->cols = cols;
+    ctx->ofs = cols + 3;
+    ctx->cap = (rows + 2) * (cols + 2);
+    ctx->epoch = 0;
+    ctx->opened = 0;
+    ctx->head = 0;
+    ctx->work_top = 0;
+    ctx->strength = SOLVER_BASIC;
+    ctx->stats = NULL;
+    ctx->stop = NULL;
+    ctx->stop_tick = 0;
+    ctx->stopped = false;
+    ctx->report.opened = 0;
+    ctx->report.start_r = ctx->report.start_c = -1;
+    ctx->report.stopped = false;
+    ctx->open_mark = solver_marks_alloc(ctx);
+    ctx->mine_mark = solver_marks_alloc(ctx);
+    ctx->work_mark = solver_marks_alloc(ctx);
+    ctx->opened_list = (int*)malloc(n * sizeof(int));
+    ctx->work = (int*)malloc(n * sizeof(int));
+    /*    ,     n/2 + 1 */
+    ctx->seen_epoch = 0;
+    ctx->seen_mark = solver_marks_alloc(ctx);
+    ctx->openings = (struct SolverOpening*)malloc((n / 2 + 1) * sizeof(struct SolverOpening));
+    if (!ctx->open_mark || !ctx->mine_mark || !ctx->work_mark || !ctx->opened_list || !ctx->work
+        || !ctx->seen_mark || !ctx->openings) {
+        solver_ctx_free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+/*    */
+void solver_ctx_free(SolverCtx* ctx) {
+    if (!ctx) return;
+    solver_marks_free(ctx, ctx->open_mark);
+    solver_marks_free(ctx, ctx->mine_mark);
+    solver_marks_free(ctx, ctx->work_mark);
+    free(ctx->opened_list);
+    free(ctx->work);
+    solver_marks_free(ctx, ctx->seen_mark);
+    free(ctx->openings);
+    free(ctx);
+}
+
+/*     : O(1),     */
+static void solver_reset(SolverCtx* ctx) {
+    if (++ctx->epoch == 0) {
+        solver_marks_clear(ctx, ctx->open_mark);
+        solver_marks_clear(ctx, ctx->mine_mark);
+        solver_marks_clear(ctx, ctx->work_mark);
+        ctx->epoch = 1;
+    }
+    ctx->opened = 0;
+    ctx->head = 0;
+    ctx->work_top = 0;
+    ctx->subset_pos = 0;
+}
+
+/*     p    (    ) */
+static void solver_push(const Field* f, SolverCtx* ctx, int p) {
+    if (ctx->open_mark[p] != ctx->epoch || f->count[p] == 0) return;
+    if (ctx->work_mark[p] == ctx->epoch) return;
+    ctx->work_mark[p] = ctx->epoch;
+    ctx->work[ctx->work_top++] = p;
+}
+
+/*   p :      "".
+       ,     . */
+static void solver_touch(const Field* f, SolverCtx* ctx, int p) {
+    for (int k = 0; k < 8; ++k)
+        solver_push(f, ctx, p + f->nbr[k]);
+}
+
+/*   p (  ) */
+static void solver_open(const Field* f, SolverCtx* ctx, int p) {
+    ctx->open_mark[p] = ctx->epoch;
+    ctx->opened_list[ctx->opened++] = p;
+    solver_push(f, ctx, p);
+    solver_touch(f, ctx, p);
+}
+
+/*   p   */
+static void solver_mark_mine(const Field* f, SolverCtx* ctx, int p) {
+    ctx->mine_mark[p] = ctx->epoch;
+    solver_touch(f, ctx, p);
+}
+
+bool solver_stop_reached(const SolverStop* stop) {
+    if (!stop) return false;
+    if (stop->cancel && mt_atomic_load(stop->cancel) != 0) return true;
+    return stop->deadline_ns != 0 && mt_now_ns() >= stop->deadline_ns;
+}
+
+/*   :   ;   SOLVER_STOP_STRIDE 
+    ctx->stop.  true,    . */
+static inline bool solver_stop_due(SolverCtx* ctx) {
+    if (!ctx->stop) return false;
+    if (ctx->stopped) return true;
+    if (++ctx->stop_tick < SOLVER_STOP_STRIDE) return false;
+    ctx->stop_tick = 0;
+    ctx->stopped = solver_stop_reached(ctx->stop);
+    return ctx->stopped;
+}
+
+/*   FIELD_STOP_CELLS ;       */
+bool compute_counts_until(Field* f, const SolverStop* stop) {
+    if (!f) return true;
+    if (!stop || FIELD_FIXED(f)) { compute_counts(f); return true; }
+    int band = FIELD_STOP_CELLS / f->cols;
+    if (band < 1) band = 1;
+    for (int r = 0; r < f->rows; ) {
+        if (solver_stop_reached(stop)) return false;
+        int r1 = f->rows - r > band ? r + band : f->rows;
+        compute_counts_rows(f, r, r1);
+        r = r1;
+    }
+    return true;
+}
+
+/* : BFS   +  A/B     ,
+       */
+static void solver_propagate(const Field* f, SolverCtx* ctx) {
+    const int* nb = f->nbr;
+    unsigned int ep = ctx->epoch;
+    STAT_ADD(ctx->stats, rule_passes, 1);
+
+    for (;;) {
+        /*   : opened_list    BFS */
+        while (ctx->head < ctx->opened) {
+            if (solver_stop_due(ctx)) return;
+            int cur = ctx->opened_list[ctx->head++];
+            if (f->count[cur] != 0) continue;
+            /*    -;     FIELD_BORDER */
+            for (int k = 0; k < 8; ++k) {
+                int p2 = cur + nb[k];
+                if (ctx->open_mark[p2] != ep && f->count[p2] != FIELD_BORDER)
+                    solver_open(f, ctx, p2);
+            }
+        }
+
+        if (ctx->work_top == 0) break; /*        */
+        if (solver_stop_due(ctx)) return;
+
+        int p = ctx->work[--ctx->work_top];
+        ctx->work_mark[p] = 0;
+        STAT_ADD(ctx->stats, work_items, 1);
+
+        int n = f->count[p]; /*     */
+        int inferred_neighbors = 0; /*      */
+        int unknown_list[8];
+        int unknown_k = 0; /*       */
+
+        for (int k = 0; k < 8; ++k) {
+            int p2 = p + nb[k];
+            if (ctx->mine_mark[p2] == ep) inferred_neighbors++;
+            else if (ctx->open_mark[p2] != ep && f->count[p2] != FIELD_BORDER)
+                unknown_list[unknown_k++] = p2;
+        }
+        if (unknown_k == 0) continue;
+
+        /*  A:   == known + unknown ->  unknown   */
+        if (n == inferred_neighbors + unknown_k) {
+            for (int k = 0; k < unknown_k; ++k)
+                solver_mark_mine(f, ctx, unknown_list[k]);
+        }
+        /*  B:   == known ->  unknown  ->   */
+        else if (n == inferred_neighbors) {
+            for (int k = 0; k < unknown_k; ++k)
+                if (ctx->open_mark[unknown_list[k]] != ep)
+                    solver_open(f, ctx, unknown_list[k]);
         }
     }
+}
 
-    /*       */
-    bool changed = true;
-    while (changed) {
-        changed = false;
-
-        /*           */
-        for (int r = 0; r < R; ++r) {
-            for (int c = 0; c < C; ++c) {
-                int p = IDX(f, r, c);
-                if (state[p] < 0) continue; /*     */
-
-                int n = state[p]; /*     */
-				int inferred_neighbors = 0; /*      */
-				int unknown_neighbors = 0; /*       */
-                int unknown_list[8];
-                int unknown_k = 0;
-
-                for (int dr = -1; dr <= 1; ++dr)
-                    for (int dc = -1; dc <= 1; ++dc) {
-                        if (dr == 0 && dc == 0) continue;
-                        int rr = r + dr, cc = c + dc;
-                        if (rr >= 0 && rr < R && cc >= 0 && cc < C) {
-                            int p2 = IDX(f, rr, cc);
-                            if (inferred_mine[p2]) inferred_neighbors++;
-                            else if (state[p2] == -1) {
-                                unknown_list[unknown_k++] = p2;
-                                unknown_neighbors++;
-                            }
-                        }
-                    }
-
-                /*  A:   == known + unknown ->  unknown   */
-                if (unknown_neighbors > 0 && n == inferred_neighbors + unknown_neighbors) {
-                    for (int k = 0; k < unknown_k; ++k) {
-                        int p2 = unknown_list[k];
-                        if (!inferred_mine[p2]) {
-                            inferred_mine[p2] = 1;
-                            changed = true;
-                        }
-                    }
-                }
-                
-                /*  B:   == known ->  unknown  ->   */
-                if (unknown_neighbors > 0 && n == inferred_neighbors) {
-                    for (int k = 0; k < unknown_k; ++k) {
-                        int p2 = unknown_list[k];
-                        if (state[p2] == -1 && !inferred_mine[p2]) {
-                            state[p2] = f->count[p2];
-                            changed = true;
-                            /*     ,     flood-fill */
-                            if (f->count[p2] == 0) queue[qt++] = p2;
-                        }
-                    }
+/*   p:         .
+       (0       ). */
+static int solver_constraint(const Field* f, const SolverCtx* ctx, int p, int* unknown, int* left) {
+    unsigned int ep = ctx->epoch;
+    int k_unknown = 0, inferred = 0;
+    for (int k = 0; k < 8; ++k) {
+        int p2 = p + f->nbr[k];
+        if (ctx->mine_mark[p2] == ep) inferred++;
+        else if (ctx->open_mark[p2] != ep && f->count[p2] != FIELD_BORDER)
+            unknown[k_unknown++] = p2;
+    }
+    *left = f->count[p] - inferred;
+    return k_unknown;
+}
+
+static bool list_has(const int* list, int n, int v) {
+    for (int k = 0; k < n; ++k) if (list[k] == v) return true;
+    return false;
+}
+
+/*   "    " (mine = true)  " " */
+static bool solver_decide(const Field* f, SolverCtx* ctx, const int* cells, int n, bool mine) {
+    bool changed = false;
+    for (int k = 0; k < n; ++k) {
+        int p = cells[k];
+        if (ctx->open_mark[p] == ctx->epoch || ctx->mine_mark[p] == ctx->epoch) continue;
+        if (mine) solver_mark_mine(f, ctx, p);
+        else solver_open(f, ctx, p);
+        changed = true;
+    }
+    return changed;
+}
+
+/*     A (ua, ma)  B (ub, mb)   .
+    x     ;   
+       max(0, ma - |A\B|, mb - |B\A|) <= x <= min(|A&B|, ma, mb).
+       x  B\A      ;
+       x   B\A      .
+        (A   B =>  B\A  mb - ma ),
+       1-2  1-2-1. */
+static bool solver_pair(const Field* f, SolverCtx* ctx,
+    const int* ua, int na, int ma, const int* ub, int nb, int mb) {
+    int both[8], only_a[8], only_b[8];
+    int n_both = 0, n_a = 0, n_b = 0;
+    for (int k = 0; k < na; ++k) {
+        if (list_has(ub, nb, ua[k])) both[n_both++] = ua[k];
+        else only_a[n_a++] = ua[k];
+    }
+    if (n_both == 0) return false;
+    for (int k = 0; k < nb; ++k)
+        if (!list_has(ua, na, ub[k])) only_b[n_b++] = ub[k];
+
+    int lo = 0, hi = n_both;
+    if (ma - n_a > lo) lo = ma - n_a;
+    if (mb - n_b > lo) lo = mb - n_b;
+    if (ma < hi) hi = ma;
+    if (mb < hi) hi = mb;
+
+    bool changed = false;
+    if (n_b > 0 && mb - lo == 0) changed |= solver_decide(f, ctx, only_b, n_b, false);
+    else if (n_b > 0 && mb - hi == n_b) changed |= solver_decide(f, ctx, only_b, n_b, true);
+    if (n_a > 0 && ma - lo == 0) changed |= solver_decide(f, ctx, only_a, n_a, false);
+    else if (n_a > 0 && ma - hi == n_a) changed |= solver_decide(f, ctx, only_a, n_a, true);
+    if (lo == n_both) changed |= solver_decide(f, ctx, both, n_both, true);
+    else if (hi == 0) changed |= solver_decide(f, ctx, both, n_both, false);
+    return changed;
+}
+
+/*    (SOLVER_SUBSET):   
+     .      ;
+        true,      .
+          (subset_pos),     . */
+static bool solver_subset_pass(const Field* f, SolverCtx* ctx) {
+    int ua[8], ub[8];
+    unsigned int ep = ctx->epoch;
+    int n_open = ctx->opened;
+
+    for (int i = 0; i < n_open; ++i) {
+        if (solver_stop_due(ctx)) return false;
+        int k = (ctx->subset_pos + i) % n_open;
+        int a = ctx->opened_list[k];
+        if (f->count[a] == 0) continue;
+        int ma, na = solver_constraint(f, ctx, a, ua, &ma);
+        if (na == 0) continue;
+
+        /*         5x5 */
+        int ra = a / f->stride, ca = a % f->stride;
+        for (int dr = -2; dr <= 2; ++dr)
+            for (int dc = -2; dc <= 2; ++dc) {
+                int rb = ra + dr, cb = ca + dc;
+                if (rb < 0 || rb >= f->rows || cb < 0 || cb >= f->cols) continue;
+                int b = (int)IDX(f, rb, cb);
+                if (b <= a) continue; /*     */
+                if (ctx->open_mark[b] != ep || f->count[b] == 0) continue;
+                int mb, nb = solver_constraint(f, ctx, b, ub, &mb);
+                if (nb == 0) continue;
+                if (solver_pair(f, ctx, ua, na, ma, ub, nb, mb)) {
+                    ctx->subset_pos = k;
+                    return true;
                 }
             }
-        }
+    }
+    return false;
+}
+
+/*   :    ,  ( )
+    ,    ,  -  */
+static void solver_run(const Field* f, SolverCtx* ctx) {
+    int safe_total = f->rows * f->cols - f->mines;
+    for (;;) {
+        solver_propagate(f, ctx);
+        if (ctx->stopped || ctx->opened == safe_total || ctx->strength < SOLVER_SUBSET) break;
+        STAT_ADD(ctx->stats, subset_passes, 1);
+        if (!solver_subset_pass(f, ctx)) break;
+        STAT_ADD(ctx->stats, subset_hits, 1);
+    }
+}
+
+void solver_ctx_set_strength(SolverCtx* ctx, SolverStrength strength) {
+    if (ctx) ctx->strength = strength;
+}
+
+void solver_ctx_set_stats(SolverCtx* ctx, GenStats* stats) {
+    if (ctx) ctx->stats = stats;
+}
+
+void solver_ctx_set_stop(SolverCtx* ctx, const SolverStop* stop) {
+    if (!ctx) return;
+    ctx->stop = stop;
+    ctx->stop_tick = 0;
+    ctx->stopped = false;
+}
 
-        /*        (BFS) */
+/*          */
+bool simulate_solver_ctx(const Field* f, SolverCtx* ctx, int start_r, int start_c) {
+    if (!f || !ctx || !solver_ctx_fits(ctx, f)) return false;
+    if (start_r < 0 || start_r >= f->rows || start_c < 0 || start_c >= f->cols) return false;
+
+    int start_idx = (int)IDX(f, start_r, start_c);
+    if (f->is_mine[start_idx]) return false;
+
+    solver_reset(ctx);
+    ctx->stopped = false;
+    solver_open(f, ctx, start_idx);
+    solver_run(f, ctx);
+    STAT_ADD(ctx->stats, solver_runs, 1);
+    STAT_ADD(ctx->stats, cells_opened, ctx->opened);
+
+    /*  true       */
+    return !ctx->stopped && ctx->opened == f->rows * f->cols - f->mines;
+}
+
+/*   :  scratch    */
+bool simulate_solver_from(const Field* f, int start_r, int start_c) {
+    if (!f) return false;
+    const FixedKernels* fk = FIELD_FIXED(f);
+    if (fk) return fk->simulate(f, start_r, start_c, SOLVER_BASIC, NULL);
+    SolverCtx* ctx = solver_ctx_create(f->rows, f->cols);
+    if (!ctx) return false;
+    bool ok = simulate_solver_ctx(f, ctx, start_r, start_c);
+    solver_ctx_free(ctx);
+    return ok;
+}
+
+/*     seen_mark;      */
+static unsigned int solver_seen_stamp(SolverCtx* ctx) {
+    if (++ctx->seen_epoch == 0) {
+        solver_marks_clear(ctx, ctx->seen_mark);
+        ctx->seen_epoch = 1;
+    }
+    return ctx->seen_epoch;
+}
+
+/*   :        
+      ( + ). ,   - 
+     ,     base.   . */
+static int solver_label_openings(const Field* f, SolverCtx* ctx, unsigned int base) {
+    int R = f->rows, C = f->cols;
+    int count = 0;
+    int* queue = ctx->work; /*      */
+
+    for (int r0 = 0; r0 < R; ++r0)
+    for (int c0 = 0; c0 < C; ++c0) {
+        int s = (int)IDX(f, r0, c0);
+        if (f->is_mine[s] || f->count[s] != 0) continue;
+        if (ctx->seen_mark[s] >= base) continue; /*   -  */
+        if (solver_stop_due(ctx)) return count;
+
+        unsigned int stamp = solver_seen_stamp(ctx); /*    */
+        int qh = 0, qt = 0, size = 1;
+        ctx->seen_mark[s] = stamp;
+        queue[qt++] = s;
         while (qh < qt) {
+            if (solver_stop_due(ctx)) return count;
             int cur = queue[qh++];
-            int rr = cur / C, cc = cur % C;
-            for (int dr = -1; dr <= 1; ++dr)
-                for (int dc = -1; dc <= 1; ++dc) {
-                    if (dr == 0 && dc == 0) continue;
-                    int r2 = rr + dr, c2 = cc + dc;
-                    if (r2 >= 0 && r2 < R && c2 >= 0 && c2 < C) {
-                        int p2 = IDX(f, r2, c2);
-                        if (f->is_mine[p2]) continue;
-                        if (state[p2] == -1 && !inferred_mine[p2]) {
-                            state[p2] = f->count[p2];
-                            if (f->count[p2] == 0) queue[qt++] = p2;
-                            changed = true;  /*    */
-                        }
-                    }
-                }
+            for (int k = 0; k < 8; ++k) {
+                int p2 = cur + f->nbr[k];
+                /*      ,
+                          */
+                if (ctx->seen_mark[p2] == stamp || f->count[p2] == FIELD_BORDER) continue;
+                ctx->seen_mark[p2] = stamp;
+                ++size;
+                if (f->count[p2] == 0) queue[qt++] = p2;
+            }
         }
-        /*          , 
-          / */
+        ctx->openings[count].start = s;
+        ctx->openings[count].size = size;
+        ++count;
     }
+    return count;
+}
 
-    /*     */
-    int opened = 0;
-    for (int i = 0; i < N; ++i) if (!f->is_mine[i] && state[i] >= 0) ++opened;
+/*  :   ,      */
+static int opening_cmp(const void* a, const void* b) {
+    const struct SolverOpening* x = (const struct SolverOpening*)a;
+    const struct SolverOpening* y = (const struct SolverOpening*)b;
+    if (x->size != y->size) return (x->size > y->size) ? -1 : 1;
+    return (x->start > y->start) - (x->start < y->start);
+}
 
-    free(queue);
-    free(inferred_mine);
-    free(state);
+/*      p   .    
+      cover:  ,      
+           .
+           ctx->report. */
+static bool solver_try_start(const Field* f, SolverCtx* ctx, int p, unsigned int cover,
+    int* out_r, int* out_c) {
+    if (ctx->seen_mark[p] == cover) {
+        STAT_ADD(ctx->stats, starts_skipped, 1);
+        return false;
+    }
+    int r = p / f->stride, c = p % f->stride;
+    bool ok = simulate_solver_ctx(f, ctx, r, c);
+    if (ctx->opened > ctx->report.opened) {
+        ctx->report.opened = ctx->opened;
+        ctx->report.start_r = r;
+        ctx->report.start_c = c;
+    }
+    if (ok) {
+        if (out_r) *out_r = r;
+        if (out_c) *out_c = c;
+        return true;
+    }
+    if (ctx->stopped) return false;
+    for (int k = 0; k < ctx->opened; ++k)
+        ctx->seen_mark[ctx->opened_list[k]] = cover;
+    return false;
+}
 
-    /*  true       */
-    return opened == safe_total;
+/*   .
+   -      (  )    ,
+                
+        ,    .
+   -     ,   ""  .
+   -   ctx->stop   ,      . */
+bool check_solvability_ctx(const Field* f, SolverCtx* ctx, int* out_r, int* out_c) {
+    if (!f || !ctx || !solver_ctx_fits(ctx, f)) return false;
+    ctx->report.opened = 0;
+    ctx->report.start_r = ctx->report.start_c = -1;
+    ctx->stopped = ctx->report.stopped = solver_stop_reached(ctx->stop);
+    if (ctx->stopped) return false;
+    const FixedKernels* fk = FIELD_FIXED(f);
+    if (fk) {
+        bool ok = fk->check(f, ctx->strength, ctx->stats, ctx->stop, &ctx->report, out_r, out_c);
+        ctx->stopped = ctx->report.stopped;
+        return ok;
+    }
+    int N = f->rows * f->cols;
+
+    /*        ,  cover */
+    if (ctx->seen_epoch > 0xFFFFFFFFu - (unsigned int)N - 2u) {
+        solver_marks_clear(ctx, ctx->seen_mark);
+        ctx->seen_epoch = 0;
+    }
+    unsigned int base = ctx->seen_epoch + 1;
+
+    int n_open = solver_label_openings(f, ctx, base);
+    if (ctx->stopped) {
+        ctx->report.stopped = true;
+        return false;
+    }
+    STAT_ADD(ctx->stats, checks, 1);
+    STAT_ADD(ctx->stats, openings, n_open);
+    qsort(ctx->openings, n_open, sizeof(struct SolverOpening), opening_cmp);
+    unsigned int cover = solver_seen_stamp(ctx);
+
+    for (int k = 0; k < n_open; ++k) {
+        if (solver_try_start(f, ctx, ctx->openings[k].start, cover, out_r, out_c)) return true;
+        if (ctx->stopped) break;
+    }
+
+    for (int r = 0; r < f->rows && !ctx->stopped; ++r)
+        for (int c = 0; c < f->cols; ++c) {
+            int p = (int)IDX(f, r, c);
+            if (f->is_mine[p]) continue;
+            if (solver_stop_due(ctx)) break;
+            if (solver_try_start(f, ctx, p, cover, out_r, out_c)) return true;
+            if (ctx->stopped) break;
+        }
+    ctx->report.stopped = ctx->stopped;
+    return false;
 }
 
-/*      */
 bool check_solvability(const Field* f, int* out_r, int* out_c) {
     if (!f) return false;
-    int R = f->rows, C = f->cols;
-    for (int r = 0; r < R; ++r) {
-        for (int c = 0; c < C; ++c) {
-            int idx = IDX(f, r, c);
-            if (f->is_mine[idx]) continue;
-            if (simulate_solver_from(f, r, c)) {
-                if (out_r) *out_r = r;
-                if (out_c) *out_c = c;
-                return true;
+    const FixedKernels* fk = FIELD_FIXED(f);
+    if (fk) return fk->check(f, SOLVER_BASIC, NULL, NULL, NULL, out_r, out_c);
+    SolverCtx* ctx = solver_ctx_create(f->rows, f->cols);
+    if (!ctx) return false;
+    bool ok = check_solvability_ctx(f, ctx, out_r, out_c);
+    solver_ctx_free(ctx);
+    return ok;
+}
+
+/* ============    (repair) ============ */
+   /*
+           ,   
+      ""          .
+          :     ,
+           (  ); 
+         3x3  ,    
+         .
+     ,   ,    ,   
+             ;  
+     ,      .
+   */
+
+/*    p   :  ,  ,    */
+static bool repair_free(const Field* f, const SolverCtx* ctx, int p) {
+    return !f->is_mine[p] && ctx->open_mark[p] != ctx->epoch && ctx->mine_mark[p] != ctx->epoch;
+}
+
+/*     p    (   "") */
+static bool repair_far(const Field* f, const SolverCtx* ctx, int p) {
+    for (int k = 0; k < 8; ++k)
+        if (ctx->open_mark[p + f->nbr[k]] == ctx->epoch) return false;
+    return true;
+}
+
+/*    :   ,   
+     . far = true       . */
+static int repair_find(const Field* f, const SolverCtx* ctx, Rng* g, bool far) {
+    int N = f->rows * f->cols, C = f->cols;
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        int t = (int)rng_below(g, (uint32_t)N);
+        int p = (int)IDX(f, t / C, t % C);
+        if (repair_free(f, ctx, p) && (!far || repair_far(f, ctx, p))) return p;
+    }
+    int t0 = (int)rng_below(g, (uint32_t)N);
+    for (int j = 0; j < N; ++j) {
+        int t = (t0 + j) % N;
+        int p = (int)IDX(f, t / C, t % C);
+        if (repair_free(f, ctx, p) && (!far || repair_far(f, ctx, p))) return p;
+    }
+    return -1;
+}
+
+/*      p .    
+           ,    0: BFS   
+    ,   B      . */
+static void repair_touch(const Field* f, SolverCtx* ctx, int p) {
+    for (int k = 0; k < 8; ++k) {
+        int p2 = p + f->nbr[k];
+        if (ctx->open_mark[p2] != ctx->epoch || ctx->work_mark[p2] == ctx->epoch) continue;
+        ctx->work_mark[p2] = ctx->epoch;
+        ctx->work[ctx->work_top++] = p2;
+    }
+}
+
+/*   ,     .
+   inferred = false:  ,    ;
+   inferred = true :    (   ""
+                     );    .
+           ( ),  
+   can_drop (  )  ,     .
+         (0    ). */
+static int repair_round(Field* f, SolverCtx* ctx, Rng* g, bool inferred, bool can_drop) {
+    unsigned int ep = ctx->epoch;
+    int moved = 0;
+    bool far = true;
+    for (int k = 0; k < ctx->opened; ++k) {
+        int a = ctx->opened_list[k];
+        if (f->count[a] == 0) continue;
+        for (int j = 0; j < 8; ++j) {
+            int p = a + f->nbr[j];
+            if (!f->is_mine[p] || (ctx->mine_mark[p] == ep) != inferred) continue;
+
+            int t = far ? repair_find(f, ctx, g, true) : -1;
+            if (t < 0) far = false; /*            */
+            ctx->mine_mark[p] = 0;
+            if (t < 0 && can_drop) {
+                field_toggle_mine(f, p / f->stride, p % f->stride);
             }
+            else {
+                if (t < 0) t = repair_find(f, ctx, g, false);
+                if (t < 0) return moved;
+                field_move_mine(f, p / f->stride, p % f->stride, t / f->stride, t % f->stride);
+                repair_touch(f, ctx, t);
+            }
+            /*     :    "" */
+            repair_touch(f, ctx, p);
+            ++moved;
+        }
+    }
+    return moved;
+}
+
+bool generate_repair(Field* f, SolverCtx* ctx, int percent, int mines,
+    int start_r, int start_c, int max_rounds, Rng* g, int* rounds_used) {
+    if (rounds_used) *rounds_used = 0;
+    if (!f || !ctx || !g || !solver_ctx_fits(ctx, f)) return false;
+    if (start_r < 0 || start_r >= f->rows || start_c < 0 || start_c >= f->cols) return false;
+    ctx->stopped = false;
+
+    if (mines >= 0) generate_exact_rng(f, mines, g);
+    else generate_by_probability_rng(f, percent, g);
+
+    /*     :        */
+    int start = (int)IDX(f, start_r, start_c);
+    if (f->is_mine[start]) {
+        int N = f->rows * f->cols;
+        int t0 = (int)rng_below(g, (uint32_t)N);
+        for (int j = 0; j < N; ++j) {
+            int t = (t0 + j) % N;
+            if (IDX(f, t / f->cols, t % f->cols) == start || FIELD_MINE(f, t / f->cols, t % f->cols)) continue;
+            field_move_mine(f, start_r, start_c, t / f->cols, t % f->cols);
+            break;
+        }
+        if (f->is_mine[start]) return false; /*     */
+    }
+
+    int round = 0;
+    for (;;) {
+        /*     :   ,    */
+        solver_reset(ctx);
+        solver_open(f, ctx, start);
+        solver_run(f, ctx);
+        STAT_ADD(ctx->stats, solver_runs, 1);
+        if (ctx->stopped) return false;
+        if (ctx->opened == f->rows * f->cols - f->mines) return true;
+
+        /*    ,        */
+        while (ctx->opened < f->rows * f->cols - f->mines) {
+            if (round >= max_rounds) return false;
+            if (rounds_used) *rounds_used = round + 1;
+            ++round;
+            STAT_ADD(ctx->stats, repair_rounds, 1);
+            int moved = repair_round(f, ctx, g, false, mines < 0);
+            if (moved == 0) moved = repair_round(f, ctx, g, true, mines < 0);
+            STAT_ADD(ctx->stats, mines_moved, moved);
+            if (moved == 0) return false;
+            solver_run(f, ctx);
+            if (ctx->stopped) return false; /*   :     */
         }
     }
-    return false;
 }
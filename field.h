@@ -7,22 +7,49 @@
 #include <stdio.h> // работа с памятью, генерация случайных чисел, exit, malloc, free
 #include <string.h> // работа со строками и памятью (memset, memcpy, strlen и т.д.)
 #include <stdbool.h>
+#include <stddef.h>
+#include "rng.h"
+#include "stats.h"
 
 /* -------------------------------------------------------------------
    Макрос IDX(INDEX): переводит координаты (r,c) в индекс линейного массива.
+   Массивы хранятся с рамкой в одну клетку, поэтому шаг строки — stride = cols + 2,
+   а допустимы и координаты рамки r = -1..rows, c = -1..cols.
+   Индекс 64-битный (ptrdiff_t): поле может содержать больше 2^31 клеток.
+   Солвер и генераторы с выборкой клеток (точное число мин, первый клик, починка)
+   хранят номера клеток в int и принимают поля не больше FIELD_MAX_SOLVER_CELLS.
    ------------------------------------------------------------------- */
-#define IDX(f, r, c) ( (int)((r) * (f)->cols + (c)) )
+#define IDX(f, r, c) ( (ptrdiff_t)(r) * (f)->stride + (c) )
+
+/* Наибольшее поле (с рамкой) для солвера и генераторов с выборкой клеток */
+#define FIELD_MAX_SOLVER_CELLS 0x7FFFFFFF
+
+/* Помещается ли поле rows x cols (с рамкой) в 32-битные номера клеток */
+#define FIELD_FITS_INT(rows, cols) \
+    ((long long)((rows) + 2) * ((cols) + 2) <= FIELD_MAX_SOLVER_CELLS)
+
+/* Доступ к клетке (r,c) без ручного учёта рамки */
+#define FIELD_MINE(f, r, c)  ((f)->is_mine[IDX(f, r, c)])
+#define FIELD_COUNT(f, r, c) ((f)->count[IDX(f, r, c)])
+
+/* Значение count в клетках рамки: по нему обход соседей отличает рамку от поля */
+#define FIELD_BORDER 0xFF
 
 /* Field хранит:
    - rows, cols : размеры поля
-   - mines      : текущее число расставленных мин
-   - is_mine    : линейный массив длины rows*cols; 1 = мина, 0 = нет
-   - count      : линейный массив длины rows*cols; count[i] = число мин вокруг клетки i
+   - mines      : текущее число расставленных мин (не больше INT_MAX)
+   - stride     : шаг строки в линейных массивах (cols + 2)
+   - nbr        : смещения 8 соседей в линейном массиве (для обхода без проверок границ)
+   - is_mine    : 1 = мина, 0 = нет; указывает на клетку (0,0) внутри массива с рамкой,
+                  в рамке всегда 0
+   - count      : count[i] = число мин вокруг клетки i; в рамке FIELD_BORDER
 */
 typedef struct {
     int rows;
     int cols;
     int mines;
+    int stride;
+    int nbr[8];
     unsigned char* is_mine;
     unsigned char* count;
 } Field;
@@ -45,22 +72,70 @@ void field_free(Field* f);
 */
 void field_clear(Field* f);
 
+/* field_copy
+   - Копирует мины и счётчики src в dst (размеры должны совпадать; иначе false).
+*/
+bool field_copy(Field* dst, const Field* src);
+
 /* compute_counts
    - Для каждой клетки, если она не мина, вычисляет количество мин среди 8 соседей.
    - Результат записывается в f->count.
 */
 void compute_counts(Field* f);
 
+/* compute_counts_rows
+   - compute_counts только для строк [r0, r1): основа полосной параллельной
+     версии (parfield.h).
+*/
+void compute_counts_rows(Field* f, int r0, int r1);
+
 /* generate_by_probability
    - Заполняет поле минами с заданной вероятностью (в процентах).
    - После расстановки мин вызывает compute_counts для обновления счётчиков.
+   - Глобальный rand() используется только для зерна (см. generate_by_probability_rng).
 */
 void generate_by_probability(Field* f, int percent);
 
+/* generate_by_probability_rng
+   - То же, что generate_by_probability, но берёт случайные числа из переданного
+     генератора g, а не из глобального rand(). Потокобезопасно при отдельном g
+     на каждый поток; одинаковое состояние g даёт одинаковое поле.
+*/
+void generate_by_probability_rng(Field* f, int percent, Rng* g);
+
+/* generate_exact / generate_exact_rng
+   - Расставляет ровно mines мин (ограничивается диапазоном 0..rows*cols),
+     все расстановки равновероятны (выборка Флойда, O(mines) случайных чисел).
+   - Счётчики обновляются по ходу расстановки, отдельный compute_counts не нужен.
+   - generate_exact берёт зерно из rand(), generate_exact_rng — из переданного генератора.
+*/
+void generate_exact(Field* f, int mines);
+void generate_exact_rng(Field* f, int mines, Rng* g);
+
+/* place_by_probability_rng
+   - Расстановка мин как в generate_by_probability_rng, но без compute_counts:
+     f->mines заполнено, счётчики не пересчитаны. Для случаев, когда счётчики
+     считаются отдельно (замеры по фазам, bitfield_compute_counts).
+*/
+void place_by_probability_rng(Field* f, int percent, Rng* g);
+
+/* field_toggle_mine
+   - Ставит мину в пустую клетку (r,c) или убирает её, обновляя f->mines и счётчики
+     только в окрестности 3x3 (O(1), без compute_counts).
+*/
+void field_toggle_mine(Field* f, int r, int c);
+
+/* field_move_mine
+   - Переносит мину из (from_r,from_c) в пустую клетку (to_r,to_c) за O(1).
+   - Возвращает false, если в исходной клетке нет мины или целевая занята.
+*/
+bool field_move_mine(Field* f, int from_r, int from_c, int to_r, int to_c);
+
 /* print_field_ascii
    - Печатает поле в виде таблицы.
    - show_mines=true: мины отображаются '*'.
    - Значение 0 отображается как '.', 1..8 — цифры.
+   - Для окна или обзора больших полей — render_viewport / render_overview (render.h).
 */
 void print_field_ascii(const Field* f, bool show_mines);
 
@@ -71,13 +146,33 @@ void print_field_ascii(const Field* f, bool show_mines);
 */
 bool save_field_to_file(const Field* f, const char* fname);
 
+/* write_field
+   - Записывает поле в уже открытый поток в том же формате, что save_field_to_file.
+   - Несколько полей подряд в одном файле образуют корпус: каждое начинается
+     со своей строки "rows cols mines".
+   - Возвращает false при ошибке записи.
+*/
+bool write_field(const Field* f, FILE* out);
+
+/* write_field_rows
+   - Только строки поля, без заголовка: для записи поля по частям (tiled.h).
+*/
+bool write_field_rows(const Field* f, FILE* out);
+
 /* validate_field
    - Для каждой неминной клетки пересчитывает число соседних мин и сравнивает
      с f->count[i]. Печатает ошибку для несоответствий и возвращает false,
      если хоть одно несоответствие найдено.
+   - Список ошибок без печати и в несколько потоков — validate_field_mt (parfield.h).
 */
 bool validate_field(const Field* f);
 
+/* validate_field_quiet
+   - Та же проверка без печати: возвращает число несоответствий (0 — поле корректно,
+     -1 — f == NULL).
+*/
+int validate_field_quiet(const Field* f);
+
 /* simulate_solver_from
       - Пытаемся логически раскрыть всё поле, начиная со start_r,start_c.
       - Возвращает true, если все безопасные клетки можно открыть, применяя только локальную логику.
@@ -89,6 +184,131 @@ bool validate_field(const Field* f);
 */
 bool simulate_solver_from(const Field* f, int start_r, int start_c);
 
+/* SolverStrength — какие рассуждения разрешены солверу
+   - SOLVER_BASIC  : только два правила одной клетки (A и B, см. simulate_solver_from).
+   - SOLVER_SUBSET : дополнительно, когда простые правила остановились, сравниваются
+                     ограничения пар соседних числовых клеток (правила подмножества и
+                     разности, шаблоны 1-2, 1-2-1). Принимает больше полей за попытку.
+*/
+typedef enum {
+    SOLVER_BASIC = 0,
+    SOLVER_SUBSET = 1
+} SolverStrength;
+
+/* SolverStop
+   - Условие прерывания солвера: срок deadline_ns по часам mt_now_ns (0 — без срока)
+     и флаг cancel (не NULL и не 0 — прервать; меняется атомарно из другого потока).
+*/
+typedef struct {
+    uint64_t deadline_ns;
+    volatile long* cancel;
+} SolverStop;
+
+/* Раз в сколько шагов солвера (клеток раскрытия, элементов рабочего списка,
+   клеток разметки) проверяется SolverStop */
+#define SOLVER_STOP_STRIDE 1024
+
+/* Раз в сколько клеток расстановка мин и подсчёт счётчиков под SolverStop
+   (fdesc_place_until, compute_counts_until) проверяют условие: проверка идёт
+   между строками, на узком поле — каждую строку */
+#define FIELD_STOP_CELLS 65536
+
+/* SolverReport
+   - Итог перебора стартов check_solvability_ctx: наибольшее число открытых
+     клеток среди запусков и старт, который его дал (-1, -1 — запусков не было),
+     а также был ли перебор прерван по SolverStop.
+*/
+typedef struct {
+    int opened;
+    int start_r, start_c;
+    bool stopped;
+} SolverReport;
+
+/* SolverCtx
+   - Рабочий контекст (scratch) солвера: выделяется один раз под размер поля
+     и переиспользуется между запусками, поэтому цикл генерации не делает malloc/free.
+   - Сброс между запусками — O(1): вместо очистки массивов увеличивается epoch,
+     и клетка считается открытой/помеченной, только если её отметка равна текущему epoch.
+     open_mark[i]  == epoch : клетка открыта
+     mine_mark[i]  == epoch : клетка точно мина (внутренняя пометка солвера)
+     work_mark[i]  == epoch : клетка уже стоит в рабочем списке
+   - opened_list: открытые клетки в порядке открытия (заодно очередь BFS для нулей).
+   - work: рабочий список "грязных" открытых числовых клеток, у соседей которых
+     что-то изменилось; правила применяются только к ним.
+*/
+typedef struct {
+    int rows, cols;          /* размеры поля, под которые выделен контекст */
+    int ofs;                 /* смещение клетки (0,0) в массивах отметок (с рамкой) */
+    int cap;                 /* длина массивов отметок вместе с рамкой */
+    unsigned int epoch;      /* номер текущего запуска */
+    unsigned int* open_mark;
+    unsigned int* mine_mark;
+    unsigned int* work_mark;
+    int* opened_list;
+    int* work;
+    int opened;              /* сколько клеток открыто в текущем запуске */
+    int head;                /* голова очереди BFS внутри opened_list */
+    int work_top;            /* размер рабочего списка */
+    SolverStrength strength; /* уровень рассуждений (по умолчанию SOLVER_BASIC) */
+    int subset_pos;          /* с какой открытой клетки продолжать второй уровень */
+    unsigned int seen_epoch; /* счётчик отметок для seen_mark */
+    unsigned int* seen_mark; /* разметка нулевых областей и "покрытых" стартов в check_solvability_ctx */
+    struct SolverOpening* openings; /* различные первые раскрытия поля */
+    GenStats* stats;         /* куда добавлять счётчики (NULL — не считать) */
+    const SolverStop* stop;  /* условие прерывания (NULL — не прерывать) */
+    int stop_tick;           /* шагов с последней проверки stop */
+    bool stopped;            /* последний запуск или перебор прерван по stop */
+    SolverReport report;     /* итог последнего check_solvability_ctx */
+} SolverCtx;
+
+/* solver_ctx_create / solver_ctx_free
+   - Выделяет контекст солвера для полей с cols столбцами и не более чем rows строками
+     (поле с рамкой — не больше FIELD_MAX_SOLVER_CELLS клеток).
+   - Возвращает NULL при ошибке. solver_ctx_free безопасно вызывать с NULL.
+*/
+SolverCtx* solver_ctx_create(int rows, int cols);
+void solver_ctx_free(SolverCtx* ctx);
+
+/* solver_ctx_set_strength
+   - Задаёт уровень рассуждений для всех следующих запусков на этом контексте.
+*/
+void solver_ctx_set_strength(SolverCtx* ctx, SolverStrength strength);
+
+/* solver_ctx_set_stats
+   - Счётчики солвера (запуски, проходы правил, открытые клетки...) добавляются в stats.
+   - NULL отключает сбор. Без FIELD_STATS счётчики не собираются вовсе.
+*/
+void solver_ctx_set_stats(SolverCtx* ctx, GenStats* stats);
+
+/* solver_ctx_set_stop
+   - Все следующие запуски на контексте проверяют stop раз в SOLVER_STOP_STRIDE шагов
+     (раскрытие, правила, второй уровень, разметка областей) и при срабатывании
+     останавливаются: simulate_solver_ctx и check_solvability_ctx возвращают false,
+     а ctx->stopped становится true. Открытое к этому моменту остаётся в ctx
+     (opened, report), поэтому частичный итог можно оценить.
+   - NULL снимает условие. stop должен жить, пока установлен.
+*/
+void solver_ctx_set_stop(SolverCtx* ctx, const SolverStop* stop);
+
+/* solver_stop_reached
+   - Сработало ли условие: истёк срок или поднят флаг. NULL — никогда.
+*/
+bool solver_stop_reached(const SolverStop* stop);
+
+/* compute_counts_until
+   - compute_counts с проверкой stop раз в FIELD_STOP_CELLS клеток (между строками).
+   - Возвращает false, если условие сработало: счётчики тогда посчитаны не все.
+     NULL — то же, что compute_counts.
+*/
+bool compute_counts_until(Field* f, const SolverStop* stop);
+
+/* simulate_solver_ctx
+   - То же, что simulate_solver_from, но на переиспользуемом контексте (без выделения памяти).
+   - Число безопасных клеток берётся как rows*cols - f->mines, поэтому f->mines
+     должно соответствовать расстановке (все генераторы это обеспечивают).
+*/
+bool simulate_solver_ctx(const Field* f, SolverCtx* ctx, int start_r, int start_c);
+
 /*
   check_solvability
   - Перебирает все неминные клетки и вызывает simulate_solver_from для каждой.
@@ -97,4 +317,35 @@ bool simulate_solver_from(const Field* f, int start_r, int start_c);
 */
 bool check_solvability(const Field* f, int* out_r, int* out_c);
 
+/* check_solvability_ctx
+   - То же, что check_solvability, но использует переданный контекст солвера.
+   - Стартовые клетки одной нулевой области дают одно и то же раскрытие, поэтому
+     солвер запускается один раз на каждую область (сначала самые большие),
+     а клетки, уже открытые неудачным запуском, повторно не пробуются.
+   - Поля стандартных размеров (fixedsize.h) проверяются ядром этого размера:
+     от ctx берутся только уровень рассуждений, stats и stop, его массивы не меняются,
+     а в ctx->report пишется итог перебора.
+   - ctx->report: лучший частичный запуск; при срабатывании stop перебор
+     прекращается (report.stopped, ctx->stopped) и функция возвращает false.
+*/
+bool check_solvability_ctx(const Field* f, SolverCtx* ctx, int* out_r, int* out_c);
+
+/* generate_repair
+   - Генерация с починкой вместо полного отбрасывания нерешаемых полей.
+   - Расставляет мины (mines >= 0 — ровно mines, иначе с вероятностью percent),
+     делает стартовую клетку (start_r,start_c) безопасной и решает поле из неё.
+     Когда солвер останавливается, мины у застрявшей границы переносятся в случайные
+     закрытые клетки вдали от открытой области (field_move_mine), а решение
+     продолжается с сохранённого состояния солвера. В конце поле проверяется
+     одним чистым запуском солвера из стартовой клетки.
+   - В режиме по вероятности несколько последних мин, которым не нашлось места вдали
+     от открытой области, убираются (f->mines это учитывает); при точном числе мин
+     число мин не меняется.
+   - Возвращает true, если за max_rounds раундов переноса поле стало решаемым из
+     стартовой клетки; в rounds_used (если не NULL) записывается число раундов.
+   - Срабатывание ctx->stop (solver_ctx_set_stop) прекращает починку: возвращается false.
+*/
+bool generate_repair(Field* f, SolverCtx* ctx, int percent, int mines,
+    int start_r, int start_c, int max_rounds, Rng* g, int* rounds_used);
+
 #endif /* MINES_FIELD_H */
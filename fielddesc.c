@@ -0,0 +1,170 @@
+#include "fielddesc.h"
+#include <limits.h>
+#include <string.h>
+
+void fdesc_init(FieldDesc* d, int rows, int cols, int percent, int mines,
+    int start_r, int start_c, SolverStrength strength, uint64_t seed) {
+    if (!d) return;
+    memset(d, 0, sizeof *d);
+    d->seed = seed;
+    d->rows = rows > 0 ? (uint32_t)rows : 0;
+    d->cols = cols > 0 ? (uint32_t)cols : 0;
+    d->version = FDESC_VERSION;
+    d->mode = mines >= 0 ? FDESC_MINES : FDESC_PERCENT;
+    d->param = mines >= 0 ? (uint32_t)mines : (uint32_t)(percent < 0 ? 0 : percent > 100 ? 100 : percent);
+    d->strength = (uint8_t)strength;
+    d->start_r = d->start_c = -1;
+    if (start_r >= 0 && start_r < rows && start_c >= 0 && start_c < cols) {
+        d->start_r = start_r;
+        d->start_c = start_c;
+        d->flags |= FDESC_FIRST_CLICK;
+    }
+}
+
+void fdesc_set_result(FieldDesc* d, const GenResult* res) {
+    if (!d || !res) return;
+    d->seed = res->attempt_seed;
+    d->flags &= ~FDESC_SOLVABLE;
+    if (res->solvable) d->flags |= FDESC_SOLVABLE;
+    if (!(d->flags & FDESC_FIRST_CLICK)) {
+        d->start_r = res->start_r;
+        d->start_c = res->start_c;
+    }
+}
+
+/* Линейные номера клеток зоны первого клика (отсортированы), их число */
+static int fdesc_excluded(const FieldDesc* d, long long* excl) {
+    int n = 0;
+    if (!(d->flags & FDESC_FIRST_CLICK)) return 0;
+    for (int r = d->start_r - 1; r <= d->start_r + 1; ++r)
+        for (int c = d->start_c - 1; c <= d->start_c + 1; ++c)
+            if (r >= 0 && r < (int)d->rows && c >= 0 && c < (int)d->cols)
+                excl[n++] = (long long)r * d->cols + c;
+    return n;
+}
+
+bool fdesc_valid(const FieldDesc* d) {
+    if (!d || d->version != FDESC_VERSION) return false;
+    if (d->rows == 0 || d->cols == 0 || d->rows > INT_MAX - 2 || d->cols > INT_MAX - 2) return false;
+    if (d->strength > SOLVER_SUBSET || (d->flags & ~(FDESC_FIRST_CLICK | FDESC_SOLVABLE))) return false;
+    if ((d->flags & FDESC_FIRST_CLICK) &&
+        (d->start_r < 0 || d->start_r >= (int32_t)d->rows || d->start_c < 0 || d->start_c >= (int32_t)d->cols))
+        return false;
+    if (d->mode == FDESC_PERCENT) return d->param <= 100;
+    if (d->mode != FDESC_MINES) return false;
+
+    /* выборка Флойда хранит номера клеток в int, как generate_exact_rng */
+    if (!FIELD_FITS_INT(d->rows, d->cols)) return false;
+    long long excl[9];
+    return (long long)d->param <= (long long)d->rows * d->cols - fdesc_excluded(d, excl);
+}
+
+long long fdesc_fill_row(unsigned char* m, long long r, int cols, uint64_t seed, uint32_t thr, bool all) {
+    long long placed = 0;
+    uint64_t cell = (uint64_t)r * (uint64_t)cols;
+    int c = 0;
+    /* нечётная клетка в начале строки берёт старшую половину своего слова */
+    if (cell & 1) {
+        m[0] = all | ((uint32_t)(rng_derive(seed, cell >> 1) >> 32) < thr);
+        placed += m[0];
+        c = 1;
+    }
+    for (; c + 1 < cols; c += 2) {
+        uint64_t x = rng_derive(seed, (cell + (uint64_t)c) >> 1);
+        m[c] = all | ((uint32_t)x < thr);
+        m[c + 1] = all | ((uint32_t)(x >> 32) < thr);
+        placed += m[c] + m[c + 1];
+    }
+    if (c < cols) {
+        m[c] = all | ((uint32_t)rng_derive(seed, (cell + (uint64_t)c) >> 1) < thr);
+        placed += m[c];
+    }
+    return placed;
+}
+
+/* Выборка Флойда на жребиях со счётчиком; зона первого клика пропускается
+   переводом номера среди разрешённых клеток в номер клетки поля */
+static bool fdesc_place_exact(const FieldDesc* d, Field* f, const SolverStop* stop) {
+    long long excl[9];
+    int n_excl = fdesc_excluded(d, excl);
+    int C = f->cols, M = f->rows * f->cols - n_excl, K = (int)d->param;
+    uint64_t key = d->seed ^ FDESC_EXACT_SALT;
+
+    for (int j = M - K; j < M; ++j) {
+        if (stop && (j - (M - K)) % FIELD_STOP_CELLS == 0 && solver_stop_reached(stop)) return false;
+        /* 64-битный остаток: смещение не больше j / 2^64 */
+        long long t = (long long)(rng_derive(key, (uint64_t)j) % ((uint64_t)j + 1));
+        for (int e = 0; e < n_excl; ++e) if (t >= excl[e]) ++t;
+        unsigned char* p = &f->is_mine[IDX(f, t / C, t % C)];
+        if (*p) {
+            t = j;
+            for (int e = 0; e < n_excl; ++e) if (t >= excl[e]) ++t;
+            p = &f->is_mine[IDX(f, t / C, t % C)];
+        }
+        *p = 1;
+    }
+    f->mines = K;
+    return true;
+}
+
+bool fdesc_place(const FieldDesc* d, Field* f) {
+    return fdesc_place_until(d, f, NULL);
+}
+
+bool fdesc_place_until(const FieldDesc* d, Field* f, const SolverStop* stop) {
+    if (!fdesc_valid(d) || !f || (uint32_t)f->rows != d->rows || (uint32_t)f->cols != d->cols) return false;
+    field_clear(f);
+    if (d->mode == FDESC_MINES) return fdesc_place_exact(d, f, stop);
+
+    uint32_t thr = rng_percent_threshold((int)d->param);
+    bool all = d->param == 100;
+    long long placed = 0;
+    int band = FIELD_STOP_CELLS / f->cols;
+    if (band < 1) band = 1;
+    for (int r = 0; r < f->rows; ++r) {
+        if (stop && r % band == 0 && solver_stop_reached(stop)) return false;
+        placed += fdesc_fill_row(f->is_mine + IDX(f, r, 0), r, f->cols, d->seed, thr, all);
+    }
+
+    /* клетки независимы, поэтому зона первого клика просто очищается */
+    long long excl[9];
+    int n_excl = fdesc_excluded(d, excl);
+    for (int e = 0; e < n_excl; ++e) {
+        unsigned char* p = &f->is_mine[IDX(f, excl[e] / f->cols, excl[e] % f->cols)];
+        placed -= *p;
+        *p = 0;
+    }
+    f->mines = placed > INT_MAX ? INT_MAX : (int)placed;
+    return true;
+}
+
+Field* fdesc_build(const FieldDesc* d) {
+    if (!fdesc_valid(d)) return NULL;
+    Field* f = field_create((int)d->rows, (int)d->cols);
+    if (!f) return NULL;
+    if (!fdesc_place(d, f)) { field_free(f); return NULL; }
+    compute_counts(f);
+    return f;
+}
+
+bool fdesc_verify(const FieldDesc* d, Field* f, SolverCtx* ctx) {
+    if (!fdesc_valid(d) || !FIELD_FITS_INT(d->rows, d->cols)) return false;
+    Field* own_f = NULL;
+    SolverCtx* own_ctx = NULL;
+    if (!f) f = own_f = field_create((int)d->rows, (int)d->cols);
+    if (!ctx) ctx = own_ctx = solver_ctx_create((int)d->rows, (int)d->cols);
+
+    bool same = false;
+    if (f && ctx && fdesc_place(d, f)) {
+        compute_counts(f);
+        solver_ctx_set_strength(ctx, (SolverStrength)d->strength);
+        int r = d->start_r, c = d->start_c;
+        bool ok = (d->flags & FDESC_FIRST_CLICK) ? simulate_solver_ctx(f, ctx, r, c)
+                                                 : check_solvability_ctx(f, ctx, &r, &c);
+        same = ok == ((d->flags & FDESC_SOLVABLE) != 0);
+        if (same && ok) same = r == d->start_r && c == d->start_c;
+    }
+    field_free(own_f);
+    solver_ctx_free(own_ctx);
+    return same;
+}
@@ -0,0 +1,98 @@
+#ifndef MINES_FIELDDESC_H
+#define MINES_FIELDDESC_H
+
+#include "generator.h"
+#include <stdint.h>
+
+/* -------------------------------------------------------------------
+   Дескриптор поля: 32 байта вместо всех клеток.
+   Расстановка мин — чистая функция (параметры, seed) на RNG со счётчиком:
+     - по вероятности: жребий клетки номер k = r*cols + c — половина числа
+       rng_derive(seed, k / 2), поэтому любую клетку (строку, полосу) можно
+       вычислить независимо от остальных (так же строит поле tiled.h);
+     - точное число мин: выборка Флойда, j-й шаг которой берёт число
+       rng_derive(seed ^ FDESC_EXACT_SALT, j), а не следующее из потока.
+   Первый клик (FDESC_FIRST_CLICK) исключает окрестность 3x3 старта.
+   Вердикт солвера (FDESC_SOLVABLE и стартовая клетка) хранится в дескрипторе
+   и перепроверяется fdesc_verify. ParGen строит попытки этой же функцией,
+   так что любое сгенерированное поле описывается дескриптором без потерь.
+   На диске — little-endian, как в памяти (формат --format desc).
+   ------------------------------------------------------------------- */
+
+/* Версия генератора: меняется при любом изменении расстановки мин */
+#define FDESC_VERSION 1
+
+/* Соль потока жребиев выборки Флойда (отделяет его от жребиев клеток) */
+#define FDESC_EXACT_SALT 0xD1B54A32D192ED03ULL
+
+/* Режим: что задаёт param */
+#define FDESC_PERCENT 0         /* param — вероятность мины, % */
+#define FDESC_MINES   1         /* param — точное число мин */
+
+/* Флаги */
+#define FDESC_FIRST_CLICK 1u    /* start — первый клик: 3x3 вокруг него без мин */
+#define FDESC_SOLVABLE    2u    /* солвер раскрывает поле со start (вердикт) */
+
+typedef struct {
+    uint64_t seed;          /* зерно поля (у ParGen — зерно принятой попытки) */
+    uint32_t rows, cols;
+    uint32_t param;         /* вероятность или число мин (mode) */
+    int32_t start_r, start_c; /* первый клик или старт, найденный солвером; -1 — нет */
+    uint8_t version;        /* FDESC_VERSION */
+    uint8_t mode;           /* FDESC_PERCENT / FDESC_MINES */
+    uint8_t strength;       /* SolverStrength, с которым получен вердикт */
+    uint8_t flags;          /* FDESC_* */
+} FieldDesc;
+
+/* fdesc_init
+   - Дескриптор без вердикта: mines >= 0 — точное число мин, иначе вероятность percent;
+     start_r, start_c внутри поля — первый клик.
+*/
+void fdesc_init(FieldDesc* d, int rows, int cols, int percent, int mines,
+    int start_r, int start_c, SolverStrength strength, uint64_t seed);
+
+/* fdesc_set_result
+   - Переносит в дескриптор итог ParGen: зерно принятой попытки, вердикт и старт.
+*/
+void fdesc_set_result(FieldDesc* d, const GenResult* res);
+
+/* fdesc_valid
+   - Версия, режим, размеры и параметры допустимы.
+*/
+bool fdesc_valid(const FieldDesc* d);
+
+/* fdesc_fill_row
+   - Мины строки r поля шириной cols в режиме вероятности (без зоны первого клика):
+     m[c] = 1, если жребий клетки меньше thr (rng_percent_threshold), all — 100%.
+   - Возвращает число мин в строке. Общая для fdesc_place и tiled.h.
+*/
+long long fdesc_fill_row(unsigned char* m, long long r, int cols, uint64_t seed, uint32_t thr, bool all);
+
+/* fdesc_place
+   - Расставляет мины дескриптора в f (размеры должны совпадать), счётчики
+     не считает — после неё нужен compute_counts. Возвращает false, если
+     дескриптор неверен или поле не подходит.
+*/
+bool fdesc_place(const FieldDesc* d, Field* f);
+
+/* fdesc_place_until
+   - fdesc_place с проверкой stop раз в FIELD_STOP_CELLS клеток (между строками,
+     в режиме числа мин — между шагами выборки). Сработавшее условие тоже даёт
+     false, расстановка тогда не закончена; отличить от ошибки можно по
+     solver_stop_reached. NULL — то же, что fdesc_place.
+*/
+bool fdesc_place_until(const FieldDesc* d, Field* f, const SolverStop* stop);
+
+/* fdesc_build
+   - Новое поле по дескриптору (мины и счётчики). NULL при ошибке.
+*/
+Field* fdesc_build(const FieldDesc* d);
+
+/* fdesc_verify
+   - Строит поле и перепроверяет вердикт тем же способом, что ParGen: с первого клика
+     одним запуском солвера, иначе check_solvability. true — совпали и вердикт,
+     и стартовая клетка. f != NULL — поле строится в f (размеры должны совпадать).
+*/
+bool fdesc_verify(const FieldDesc* d, Field* f, SolverCtx* ctx);
+
+#endif /* MINES_FIELDDESC_H */
@@ -0,0 +1,85 @@
+#include "fixedsize.h"
+
+/* Склейка имени функции с суффиксом размера (два уровня — чтобы подставился FX_SUFFIX) */
+#define FX_CAT2(a, b) a##b
+#define FX_CAT(a, b) FX_CAT2(a, b)
+
+/* Смещения 8 соседей в порядке Field::nbr; X(d) подставляется для каждого,
+   поэтому обход соседей раскрыт без цикла. FX_S берётся из текущего размера. */
+#define FX_NBR(X) X(-FX_S - 1) X(-FX_S) X(-FX_S + 1) X(-1) X(1) X(FX_S - 1) X(FX_S) X(FX_S + 1)
+
+/* Тела обхода соседей для FX_NBR (используют локальные имена ядер шаблона) */
+#define FX_SUM(d) + m[b + (d)]
+#define FX_PUSH(d) FX_FN(fx_push)(s, cnt, b + (d));
+#define FX_FLOOD(d) { int p2 = cur + (d); \
+    if (!s->open[p2] && cnt[p2] != FIELD_BORDER) FX_FN(fx_open)(s, cnt, p2); }
+#define FX_SCAN(d) { int p2 = p + (d); \
+    if (s->mine[p2]) ++inferred; \
+    else if (!s->open[p2] && cnt[p2] != FIELD_BORDER) unknown[n_unknown++] = p2; }
+#define FX_LABEL(d) { int p2 = cur + (d); \
+    if (seen[p2] != stamp && cnt[p2] != FIELD_BORDER) { \
+        seen[p2] = stamp; \
+        ++size; \
+        if (cnt[p2] == 0) queue[qt++] = p2; \
+    } }
+
+/* Начальное раскрытие, как struct SolverOpening в field.c */
+struct FxOpening {
+    int start;
+    int size;
+};
+
+static bool fx_list_has(const int* list, int n, int v) {
+    for (int k = 0; k < n; ++k) if (list[k] == v) return true;
+    return false;
+}
+
+/* opening_cmp: сначала самые большие, при равенстве — по положению */
+static int fx_opening_cmp(const void* a, const void* b) {
+    const struct FxOpening* x = (const struct FxOpening*)a;
+    const struct FxOpening* y = (const struct FxOpening*)b;
+    if (x->size != y->size) return (x->size > y->size) ? -1 : 1;
+    return (x->start > y->start) - (x->start < y->start);
+}
+
+#define FX_ROWS 9
+#define FX_COLS 9
+#define FX_SUFFIX _9x9
+#include "fixedsize_impl.h"
+#undef FX_ROWS
+#undef FX_COLS
+#undef FX_SUFFIX
+
+#define FX_ROWS 16
+#define FX_COLS 16
+#define FX_SUFFIX _16x16
+#include "fixedsize_impl.h"
+#undef FX_ROWS
+#undef FX_COLS
+#undef FX_SUFFIX
+
+#define FX_ROWS 16
+#define FX_COLS 30
+#define FX_SUFFIX _16x30
+#include "fixedsize_impl.h"
+#undef FX_ROWS
+#undef FX_COLS
+#undef FX_SUFFIX
+
+#define FX_ROWS 30
+#define FX_COLS 16
+#define FX_SUFFIX _30x16
+#include "fixedsize_impl.h"
+#undef FX_ROWS
+#undef FX_COLS
+#undef FX_SUFFIX
+
+static const FixedKernels* const FX_TABLE[] = {
+    &fx_kernels_9x9, &fx_kernels_16x16, &fx_kernels_16x30, &fx_kernels_30x16,
+};
+
+const FixedKernels* fixed_kernels(int rows, int cols) {
+    for (size_t i = 0; i < sizeof FX_TABLE / sizeof FX_TABLE[0]; ++i)
+        if (FX_TABLE[i]->rows == rows && FX_TABLE[i]->cols == cols) return FX_TABLE[i];
+    return NULL;
+}
@@ -0,0 +1,39 @@
+#ifndef MINES_FIXEDSIZE_H
+#define MINES_FIXEDSIZE_H
+
+#include "field.h"
+
+/* -------------------------------------------------------------------
+   Ядра для стандартных размеров: 9x9, 16x16, 16x30 (и 30x16).
+   compute_counts, солвер и перебор стартов check_solvability собраны
+   отдельно под каждый размер (fixedsize_impl.h подключается с размерами
+   как константами): шаг строки и смещения 8 соседей известны при
+   компиляции, обход соседей раскрыт, а рабочие массивы солвера лежат на
+   стеке — ни malloc, ни SolverCtx не нужны.
+   Результат совпадает с общими функциями field.c: тот же порядок рабочего
+   списка, стартов и выводов второго уровня, те же счётчики GenStats.
+   field.c выбирает эти ядра сам (compute_counts, simulate_solver_from,
+   check_solvability, check_solvability_ctx); сборка с FIELD_NO_FIXED
+   (в CMake: -DFIELD_NO_FIXED=ON) оставляет только общий код.
+   ------------------------------------------------------------------- */
+
+/* Ядра одного размера */
+typedef struct {
+    int rows, cols;
+    void (*compute_counts)(Field* f);
+    bool (*simulate)(const Field* f, int start_r, int start_c, SolverStrength strength, GenStats* stats);
+    bool (*check)(const Field* f, SolverStrength strength, GenStats* stats,
+        const SolverStop* stop, SolverReport* report, int* out_r, int* out_c);
+} FixedKernels;
+
+/* fixed_kernels
+   - Ядра для поля rows x cols или NULL, если такой размер не специализирован.
+   - simulate — как simulate_solver_ctx, check — как check_solvability_ctx
+     с уровнем strength; stats (может быть NULL) получает те же счётчики.
+   - check проверяет stop (может быть NULL) перед каждым запуском солвера и
+     дополняет report (если не NULL; opened и старт должны быть заранее сброшены);
+     simulate не прерывается: запуск на таком поле занимает микросекунды.
+*/
+const FixedKernels* fixed_kernels(int rows, int cols);
+
+#endif /* MINES_FIXEDSIZE_H */
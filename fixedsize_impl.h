@@ -0,0 +1,285 @@
+/* -------------------------------------------------------------------
+   Шаблон ядер одного размера (см. fixedsize.h). Подключается только из
+   fixedsize.c, по разу на размер, с определёнными FX_ROWS, FX_COLS и
+   FX_SUFFIX; защиты от повторного включения нет намеренно.
+   Индексы клеток здесь — номера в буфере с рамкой (клетка (0,0) имеет номер
+   FX_OFS), поэтому массивы состояния индексируются без сдвига. Порядок
+   номеров тот же, что у IDX, и сравнения стартов дают тот же порядок.
+   ------------------------------------------------------------------- */
+
+#define FX_S (FX_COLS + 2)
+#define FX_N (FX_ROWS * FX_COLS)
+#define FX_CAP ((FX_ROWS + 2) * FX_S)
+#define FX_OFS (FX_S + 1)
+#define FX_FN(name) FX_CAT(name, FX_SUFFIX)
+
+/* Состояние солвера: open/mine/queued — как open_mark/mine_mark/work_mark у SolverCtx */
+typedef struct {
+    unsigned char open[FX_CAP];
+    unsigned char mine[FX_CAP];
+    unsigned char queued[FX_CAP];
+    int opened_list[FX_N];
+    int work[FX_N];
+    int opened, head, work_top, subset_pos;
+    SolverStrength strength;
+    GenStats* stats;
+} FX_FN(FxSolver);
+
+static void FX_FN(fx_counts)(Field* f) {
+    const unsigned char* m = f->is_mine - FX_OFS;
+    unsigned char* out = f->count - FX_OFS;
+    for (int r = 1; r <= FX_ROWS; ++r)
+        for (int b = r * FX_S + 1; b <= r * FX_S + FX_COLS; ++b) {
+            int cnt = 0 FX_NBR(FX_SUM);
+            out[b] = m[b] ? 0 : (unsigned char)cnt;
+        }
+}
+
+static void FX_FN(fx_push)(FX_FN(FxSolver)* s, const unsigned char* cnt, int b) {
+    if (!s->open[b] || cnt[b] == 0 || s->queued[b]) return;
+    s->queued[b] = 1;
+    s->work[s->work_top++] = b;
+}
+
+static void FX_FN(fx_touch)(FX_FN(FxSolver)* s, const unsigned char* cnt, int b) {
+    FX_NBR(FX_PUSH)
+}
+
+static void FX_FN(fx_open)(FX_FN(FxSolver)* s, const unsigned char* cnt, int b) {
+    s->open[b] = 1;
+    s->opened_list[s->opened++] = b;
+    FX_FN(fx_push)(s, cnt, b);
+    FX_FN(fx_touch)(s, cnt, b);
+}
+
+static void FX_FN(fx_mark)(FX_FN(FxSolver)* s, const unsigned char* cnt, int b) {
+    s->mine[b] = 1;
+    FX_FN(fx_touch)(s, cnt, b);
+}
+
+/* solver_propagate */
+static void FX_FN(fx_propagate)(FX_FN(FxSolver)* s, const unsigned char* cnt) {
+    STAT_ADD(s->stats, rule_passes, 1);
+    for (;;) {
+        while (s->head < s->opened) {
+            int cur = s->opened_list[s->head++];
+            if (cnt[cur] != 0) continue;
+            FX_NBR(FX_FLOOD)
+        }
+        if (s->work_top == 0) break;
+
+        int p = s->work[--s->work_top];
+        s->queued[p] = 0;
+        STAT_ADD(s->stats, work_items, 1);
+
+        int n = cnt[p];
+        int inferred = 0, n_unknown = 0;
+        int unknown[8];
+        FX_NBR(FX_SCAN)
+        if (n_unknown == 0) continue;
+
+        if (n == inferred + n_unknown) {
+            for (int k = 0; k < n_unknown; ++k)
+                FX_FN(fx_mark)(s, cnt, unknown[k]);
+        }
+        else if (n == inferred) {
+            for (int k = 0; k < n_unknown; ++k)
+                if (!s->open[unknown[k]]) FX_FN(fx_open)(s, cnt, unknown[k]);
+        }
+    }
+}
+
+/* solver_constraint */
+static int FX_FN(fx_constraint)(const FX_FN(FxSolver)* s, const unsigned char* cnt, int p, int* unknown, int* left) {
+    int inferred = 0, n_unknown = 0;
+    FX_NBR(FX_SCAN)
+    *left = cnt[p] - inferred;
+    return n_unknown;
+}
+
+/* solver_decide */
+static bool FX_FN(fx_decide)(FX_FN(FxSolver)* s, const unsigned char* cnt, const int* cells, int n, bool mine) {
+    bool changed = false;
+    for (int k = 0; k < n; ++k) {
+        int p = cells[k];
+        if (s->open[p] || s->mine[p]) continue;
+        if (mine) FX_FN(fx_mark)(s, cnt, p);
+        else FX_FN(fx_open)(s, cnt, p);
+        changed = true;
+    }
+    return changed;
+}
+
+/* solver_pair */
+static bool FX_FN(fx_pair)(FX_FN(FxSolver)* s, const unsigned char* cnt,
+    const int* ua, int na, int ma, const int* ub, int nb, int mb) {
+    int both[8], only_a[8], only_b[8];
+    int n_both = 0, n_a = 0, n_b = 0;
+    for (int k = 0; k < na; ++k) {
+        if (fx_list_has(ub, nb, ua[k])) both[n_both++] = ua[k];
+        else only_a[n_a++] = ua[k];
+    }
+    if (n_both == 0) return false;
+    for (int k = 0; k < nb; ++k)
+        if (!fx_list_has(ua, na, ub[k])) only_b[n_b++] = ub[k];
+
+    int lo = 0, hi = n_both;
+    if (ma - n_a > lo) lo = ma - n_a;
+    if (mb - n_b > lo) lo = mb - n_b;
+    if (ma < hi) hi = ma;
+    if (mb < hi) hi = mb;
+
+    bool changed = false;
+    if (n_b > 0 && mb - lo == 0) changed |= FX_FN(fx_decide)(s, cnt, only_b, n_b, false);
+    else if (n_b > 0 && mb - hi == n_b) changed |= FX_FN(fx_decide)(s, cnt, only_b, n_b, true);
+    if (n_a > 0 && ma - lo == 0) changed |= FX_FN(fx_decide)(s, cnt, only_a, n_a, false);
+    else if (n_a > 0 && ma - hi == n_a) changed |= FX_FN(fx_decide)(s, cnt, only_a, n_a, true);
+    if (lo == n_both) changed |= FX_FN(fx_decide)(s, cnt, both, n_both, true);
+    else if (hi == 0) changed |= FX_FN(fx_decide)(s, cnt, both, n_both, false);
+    return changed;
+}
+
+/* solver_subset_pass */
+static bool FX_FN(fx_subset_pass)(FX_FN(FxSolver)* s, const unsigned char* cnt) {
+    int ua[8], ub[8];
+    int n_open = s->opened;
+    for (int i = 0; i < n_open; ++i) {
+        int k = (s->subset_pos + i) % n_open;
+        int a = s->opened_list[k];
+        if (cnt[a] == 0) continue;
+        int ma, na = FX_FN(fx_constraint)(s, cnt, a, ua, &ma);
+        if (na == 0) continue;
+
+        int ra = a / FX_S, ca = a % FX_S;
+        for (int dr = -2; dr <= 2; ++dr)
+            for (int dc = -2; dc <= 2; ++dc) {
+                int rb = ra + dr, cb = ca + dc;
+                if (rb < 1 || rb > FX_ROWS || cb < 1 || cb > FX_COLS) continue;
+                int b = rb * FX_S + cb;
+                if (b <= a) continue;
+                if (!s->open[b] || cnt[b] == 0) continue;
+                int mb, nb = FX_FN(fx_constraint)(s, cnt, b, ub, &mb);
+                if (nb == 0) continue;
+                if (FX_FN(fx_pair)(s, cnt, ua, na, ma, ub, nb, mb)) {
+                    s->subset_pos = k;
+                    return true;
+                }
+            }
+    }
+    return false;
+}
+
+/* simulate_solver_ctx из клетки с номером start; queued после прогона всегда пуст */
+static bool FX_FN(fx_solve)(FX_FN(FxSolver)* s, const unsigned char* cnt, int mines, int start) {
+    memset(s->open, 0, sizeof s->open);
+    memset(s->mine, 0, sizeof s->mine);
+    s->opened = s->head = s->work_top = s->subset_pos = 0;
+
+    int safe_total = FX_N - mines;
+    FX_FN(fx_open)(s, cnt, start);
+    for (;;) {
+        FX_FN(fx_propagate)(s, cnt);
+        if (s->opened == safe_total || s->strength < SOLVER_SUBSET) break;
+        STAT_ADD(s->stats, subset_passes, 1);
+        if (!FX_FN(fx_subset_pass)(s, cnt)) break;
+        STAT_ADD(s->stats, subset_hits, 1);
+    }
+    STAT_ADD(s->stats, solver_runs, 1);
+    STAT_ADD(s->stats, cells_opened, s->opened);
+    return s->opened == safe_total;
+}
+
+static void FX_FN(fx_init)(FX_FN(FxSolver)* s, SolverStrength strength, GenStats* stats) {
+    memset(s->queued, 0, sizeof s->queued);
+    s->strength = strength;
+    s->stats = stats;
+}
+
+static bool FX_FN(fx_simulate)(const Field* f, int start_r, int start_c, SolverStrength strength, GenStats* stats) {
+    if (start_r < 0 || start_r >= FX_ROWS || start_c < 0 || start_c >= FX_COLS) return false;
+    const unsigned char* cnt = f->count - FX_OFS;
+    int start = (start_r + 1) * FX_S + start_c + 1;
+    if ((f->is_mine - FX_OFS)[start]) return false;
+
+    FX_FN(FxSolver) s;
+    FX_FN(fx_init)(&s, strength, stats);
+    return FX_FN(fx_solve)(&s, cnt, f->mines, start);
+}
+
+/* check_solvability_ctx: отметки seen живут один вызов, поэтому начинаются с нуля.
+   Один запуск здесь короче SOLVER_STOP_STRIDE шагов, поэтому stop проверяется между стартами. */
+static bool FX_FN(fx_check)(const Field* f, SolverStrength strength, GenStats* stats,
+    const SolverStop* stop, SolverReport* report, int* out_r, int* out_c) {
+    const unsigned char* cnt = f->count - FX_OFS;
+    const unsigned char* m = f->is_mine - FX_OFS;
+    FX_FN(FxSolver) s;
+    unsigned int seen[FX_CAP];
+    struct FxOpening openings[FX_N / 2 + 1];
+    FX_FN(fx_init)(&s, strength, stats);
+    memset(seen, 0, sizeof seen);
+
+    /* solver_label_openings; очередь — рабочий список солвера */
+    unsigned int stamp = 0;
+    int n_open = 0;
+    int* queue = s.work;
+    for (int r = 1; r <= FX_ROWS; ++r)
+        for (int b0 = r * FX_S + 1; b0 <= r * FX_S + FX_COLS; ++b0) {
+            if (m[b0] || cnt[b0] != 0 || seen[b0]) continue;
+            ++stamp;
+            int qh = 0, qt = 0, size = 1;
+            seen[b0] = stamp;
+            queue[qt++] = b0;
+            while (qh < qt) {
+                int cur = queue[qh++];
+                FX_NBR(FX_LABEL)
+            }
+            openings[n_open].start = b0;
+            openings[n_open].size = size;
+            ++n_open;
+        }
+    STAT_ADD(stats, checks, 1);
+    STAT_ADD(stats, openings, n_open);
+    qsort(openings, n_open, sizeof openings[0], fx_opening_cmp);
+    unsigned int cover = stamp + 1;
+
+    /* solver_try_start для областей по убыванию размера, затем для остальных клеток */
+    for (int i = 0; i < n_open + FX_CAP; ++i) {
+        int b = i < n_open ? openings[i].start : i - n_open;
+        if (i >= n_open) {
+            int c = b % FX_S;
+            if (b < FX_OFS || b >= FX_CAP - FX_S || c == 0 || c > FX_COLS || m[b]) continue;
+        }
+        if (seen[b] == cover) {
+            STAT_ADD(stats, starts_skipped, 1);
+            continue;
+        }
+        if (solver_stop_reached(stop)) {
+            if (report) report->stopped = true;
+            return false;
+        }
+        bool ok = FX_FN(fx_solve)(&s, cnt, f->mines, b);
+        if (report && s.opened > report->opened) {
+            report->opened = s.opened;
+            report->start_r = b / FX_S - 1;
+            report->start_c = b % FX_S - 1;
+        }
+        if (ok) {
+            if (out_r) *out_r = b / FX_S - 1;
+            if (out_c) *out_c = b % FX_S - 1;
+            return true;
+        }
+        for (int k = 0; k < s.opened; ++k)
+            seen[s.opened_list[k]] = cover;
+    }
+    return false;
+}
+
+static const FixedKernels FX_FN(fx_kernels) = {
+    FX_ROWS, FX_COLS, FX_FN(fx_counts), FX_FN(fx_simulate), FX_FN(fx_check)
+};
+
+#undef FX_S
+#undef FX_N
+#undef FX_CAP
+#undef FX_OFS
+#undef FX_FN
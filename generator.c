@@ -0,0 +1,367 @@
+#include "generator.h"
+#include "fielddesc.h"
+#include "mt.h"
+
+/* Рабочее место одного потока */
+typedef struct {
+    ParGen* owner;
+    Field* field;
+    SolverCtx* ctx;
+    mt_thread thread;
+    GenStats stats;              /* счётчики этого потока за текущий запуск */
+    long held;                   /* номер попытки, чьё поле сейчас в field (-1 — никакой) */
+    uint64_t fill_ns;            /* длительность последней расстановки (при ограничениях) */
+} GenWorker;
+
+struct ParGen {
+    int rows, cols;
+    int threads;
+    GenWorker* workers;
+
+    /* параметры и общее состояние текущего запуска */
+    int percent;
+    int mines;                   /* >= 0: точное число мин вместо percent */
+    int start_r, start_c;        /* известный первый клик (-1 — перебирать старты) */
+    SolverStrength strength;
+    uint64_t seed;
+    volatile long next_attempt;  /* следующий номер попытки для раздачи */
+    volatile long best_attempt;  /* наименьший номер решаемой попытки (или max_attempts) */
+    volatile long attempts_made;
+    mt_mutex lock;               /* защищает best_* при редких успехах */
+    int best_r, best_c;
+    GenStats* stats;             /* сюда складываются счётчики потоков (NULL — не собирать) */
+
+    /* ограничения запуска (pargen_run_limited) */
+    bool limited;
+    SolverStop stop;             /* срок и флаг для солверов рабочих: halt или, без монитора, внешний */
+    volatile long* cancel;       /* внешний флаг отмены (NULL — нет) */
+    volatile long halt;          /* 0 или GenStatus причины остановки (GEN_TIMEOUT/GEN_CANCELLED/GEN_EXHAUSTED) */
+    volatile long running;       /* рабочих, ещё не вышедших из цикла */
+    volatile long part_opened;   /* лучший частичный итог: открыто клеток (под lock) */
+    long part_attempt;           /* -1 — частичных итогов ещё нет */
+    int part_r, part_c;
+    Field* part_field;           /* поле лучшей частичной попытки (при ограничениях) */
+};
+
+ParGen* pargen_create(int rows, int cols, int threads) {
+    if (rows <= 0 || cols <= 0) return NULL;
+    if (threads <= 0) threads = mt_cpu_count();
+
+    ParGen* g = (ParGen*)calloc(1, sizeof(ParGen));
+    if (!g) return NULL;
+    g->rows = rows;
+    g->cols = cols;
+    g->threads = threads;
+    g->start_r = g->start_c = -1;
+    mt_mutex_init(&g->lock);
+
+    g->workers = (GenWorker*)calloc(threads, sizeof(GenWorker));
+    g->part_field = field_create(rows, cols);
+    if (!g->workers || !g->part_field) { pargen_free(g); return NULL; }
+    for (int t = 0; t < threads; ++t) {
+        g->workers[t].owner = g;
+        g->workers[t].field = field_create(rows, cols);
+        g->workers[t].ctx = solver_ctx_create(rows, cols);
+        if (!g->workers[t].field || !g->workers[t].ctx) { pargen_free(g); return NULL; }
+    }
+    return g;
+}
+
+void pargen_free(ParGen* g) {
+    if (!g) return;
+    if (g->workers) {
+        for (int t = 0; t < g->threads; ++t) {
+            field_free(g->workers[t].field);
+            solver_ctx_free(g->workers[t].ctx);
+        }
+        free(g->workers);
+    }
+    field_free(g->part_field);
+    mt_mutex_destroy(&g->lock);
+    free(g);
+}
+
+int pargen_threads(const ParGen* g) {
+    return g ? g->threads : 0;
+}
+
+void pargen_set_strength(ParGen* g, SolverStrength strength) {
+    if (!g) return;
+    g->strength = strength;
+    for (int t = 0; t < g->threads; ++t) solver_ctx_set_strength(g->workers[t].ctx, strength);
+}
+
+void pargen_set_start(ParGen* g, int start_r, int start_c) {
+    if (!g) return;
+    bool inside = start_r >= 0 && start_r < g->rows && start_c >= 0 && start_c < g->cols;
+    g->start_r = inside ? start_r : -1;
+    g->start_c = inside ? start_c : -1;
+}
+
+void pargen_set_stats(ParGen* g, GenStats* stats) {
+    if (!g) return;
+    g->stats = stats;
+    for (int t = 0; t < g->threads; ++t)
+        solver_ctx_set_stats(g->workers[t].ctx, stats ? &g->workers[t].stats : NULL);
+}
+
+/* Расстановка мин одной попытки из её зерна — функцией дескриптора (fielddesc.h),
+   поэтому принятое поле воспроизводится по FieldDesc без хранения клеток.
+   s != NULL — время расстановки и подсчёта счётчиков добавляется в s.
+   stop != NULL — обе фазы прерываются по условию; false — поле не достроено. */
+static bool pargen_fill(const ParGen* g, Field* f, uint64_t seed, GenStats* s, const SolverStop* stop) {
+    (void)s; /* без FIELD_STATS не используется */
+    FieldDesc d;
+    fdesc_init(&d, g->rows, g->cols, g->percent, g->mines, g->start_r, g->start_c, g->strength, seed);
+    STAT_TIME_BEGIN(t0);
+    bool ok = fdesc_place_until(&d, f, stop);
+    STAT_TIME_END(s, STAT_PLACE, t0);
+    if (!ok) return false;
+    STAT_TIME_BEGIN(t1);
+    ok = compute_counts_until(f, stop);
+    STAT_TIME_END(s, STAT_COUNTS, t1);
+    return ok;
+}
+
+/* Останавливает запуск с причиной reason; первая причина остаётся */
+static void pargen_halt(ParGen* g, GenStatus reason) {
+    mt_atomic_cas(&g->halt, 0, (long)reason);
+}
+
+/* Причина, по которой сработал g->stop: внешняя отмена или срок */
+static GenStatus pargen_stop_reason(ParGen* g) {
+    return g->cancel && mt_atomic_load(g->cancel) != 0 ? GEN_CANCELLED : GEN_TIMEOUT;
+}
+
+/* Пора ли останавливаться: уже остановлен, отменён или истёк срок */
+static bool pargen_halted(ParGen* g) {
+    if (mt_atomic_load(&g->halt) != 0) return true;
+    if (g->cancel && mt_atomic_load(g->cancel) != 0) { pargen_halt(g, GEN_CANCELLED); return true; }
+    if (g->stop.deadline_ns == 0 || mt_now_ns() < g->stop.deadline_ns) return false;
+    pargen_halt(g, GEN_TIMEOUT);
+    return true;
+}
+
+/* Запоминает частичный итог попытки i рабочего w, если солвер открыл в ней больше всех.
+   При равенстве выигрывает меньший номер, как и у решаемых попыток. Поле попытки
+   обменивается с part_field (обмен указателей), чтобы итог не пришлось строить заново. */
+static void pargen_partial(ParGen* g, GenWorker* w, long i, int opened, int r, int c) {
+    if (opened < mt_atomic_load(&g->part_opened)) return;
+    mt_mutex_lock(&g->lock);
+    if (g->part_attempt < 0 || opened > g->part_opened
+        || (opened == g->part_opened && i < g->part_attempt)) {
+        g->part_attempt = i;
+        g->part_r = r;
+        g->part_c = c;
+        mt_atomic_store(&g->part_opened, opened);
+        Field* f = g->part_field;
+        g->part_field = w->field;
+        w->field = f;
+        w->held = -1;
+    }
+    mt_mutex_unlock(&g->lock);
+}
+
+/* Цикл рабочего потока: берёт очередной номер попытки, пока он меньше лучшего найденного */
+static void pargen_worker(void* arg) {
+    GenWorker* w = (GenWorker*)arg;
+    ParGen* g = w->owner;
+
+    for (;;) {
+        long i = mt_atomic_add(&g->next_attempt, 1);
+        if (i >= mt_atomic_load(&g->best_attempt)) break; /* отмена: уже есть решение раньше */
+        if (g->limited && pargen_halted(g)) break;
+        /* расстановка прерывается по сроку, но заведомо не успевающую этот рабочий
+           не начинает (остальные доигрывают свои): первую оцениваем по
+           GEN_FILL_NS_PER_CELL, следующие — по прошлой */
+        uint64_t t_fill = g->limited ? mt_now_ns() : 0;
+        if (g->stop.deadline_ns != 0 && t_fill + w->fill_ns >= g->stop.deadline_ns) break;
+
+        GenStats* s = g->stats ? &w->stats : NULL;
+        w->held = -1;
+        if (!pargen_fill(g, w->field, rng_derive(g->seed, (uint64_t)i), s, g->limited ? &g->stop : NULL)) {
+            /* остановлена сроком или отменой; без условия — неверный дескриптор */
+            pargen_halt(g, solver_stop_reached(&g->stop) ? pargen_stop_reason(g) : GEN_EXHAUSTED);
+            break;
+        }
+        w->held = i;
+        if (g->limited) {
+            w->fill_ns = mt_now_ns() - t_fill;
+            if (pargen_halted(g)) break;
+        }
+
+        /* при известном первом клике достаточно одного запуска солвера */
+        int r = g->start_r, c = g->start_c;
+        STAT_TIME_BEGIN(t0);
+        bool ok = (r >= 0) ? simulate_solver_ctx(w->field, w->ctx, r, c)
+                           : check_solvability_ctx(w->field, w->ctx, &r, &c);
+        STAT_TIME_END(s, STAT_SOLVE, t0);
+        if (g->limited && !ok) {
+            if (g->start_r >= 0) pargen_partial(g, w, i, w->ctx->opened, r, c);
+            else pargen_partial(g, w, i, w->ctx->report.opened, w->ctx->report.start_r, w->ctx->report.start_c);
+            if (w->ctx->stopped) {
+                pargen_halt(g, pargen_stop_reason(g)); /* солвер остановлен сроком или отменой */
+                break;
+            }
+        }
+        mt_atomic_add(&g->attempts_made, 1);
+        STAT_ADD(s, attempts, 1);
+        STAT_ADD(s, solvable, ok);
+        if (ok) {
+            mt_mutex_lock(&g->lock);
+            if (i < g->best_attempt) {
+                g->best_r = r;
+                g->best_c = c;
+                mt_atomic_store(&g->best_attempt, i);
+            }
+            mt_mutex_unlock(&g->lock);
+            break;
+        }
+    }
+    mt_atomic_add(&g->running, -1);
+}
+
+/* Поток запуска при progress/cancel: ждёт рабочих, передавая им внешнюю отмену,
+   и вызывает функцию прогресса */
+static void pargen_monitor(ParGen* g, const GenLimits* lim, int max_attempts, uint64_t t_start) {
+    uint64_t period = (uint64_t)(lim->progress_ms > 0 ? lim->progress_ms : GEN_PROGRESS_MS) * 1000000u;
+    uint64_t next_report = t_start + period;
+    while (mt_atomic_load(&g->running) > 0) {
+        mt_sleep_us(GEN_POLL_US);
+        if (lim->cancel && mt_atomic_load(lim->cancel) != 0) pargen_halt(g, GEN_CANCELLED);
+        uint64_t now = mt_now_ns();
+        if (!lim->progress || now < next_report) continue;
+        next_report = now + period;
+        GenProgress p;
+        p.attempts_made = (int)mt_atomic_load(&g->attempts_made);
+        p.max_attempts = max_attempts;
+        p.elapsed_ns = now - t_start;
+        p.solved = mt_atomic_load(&g->best_attempt) < max_attempts;
+        p.best_opened = (int)mt_atomic_load(&g->part_opened);
+        if (!lim->progress(lim->user, &p)) pargen_halt(g, GEN_CANCELLED);
+    }
+}
+
+static GenStatus pargen_start(ParGen* g, int percent, int mines, uint64_t seed, int max_attempts,
+    const GenLimits* lim, Field* out, GenResult* res) {
+    if (!g || !out || out->rows != g->rows || out->cols != g->cols) return GEN_EXHAUSTED;
+    if (max_attempts <= 0) max_attempts = 1;
+    /* мин больше, чем клеток вне зоны старта: ни одна попытка не построится */
+    FieldDesc d;
+    fdesc_init(&d, g->rows, g->cols, percent, mines, g->start_r, g->start_c, g->strength, seed);
+    if (!fdesc_valid(&d)) {
+        if (res) {
+            res->solvable = false;
+            res->attempt = -1;
+            res->attempt_seed = 0;
+            res->start_r = res->start_c = -1;
+            res->attempts_made = 0;
+            res->opened = -1;
+        }
+        return GEN_EXHAUSTED;
+    }
+    uint64_t t_start = lim ? mt_now_ns() : 0;
+
+    g->percent = percent;
+    g->mines = mines;
+    g->seed = seed;
+    g->next_attempt = 0;
+    g->best_attempt = max_attempts;
+    g->attempts_made = 0;
+    g->best_r = g->best_c = -1;
+    g->limited = lim != NULL;
+    g->stop.deadline_ns = lim ? lim->deadline_ns : 0;
+    g->cancel = lim ? lim->cancel : NULL;
+    g->halt = 0;
+    /* первый рабочий выполняется в вызывающем потоке, если тот не следит за прогрессом;
+       без монитора внешний флаг отмены солверы и расстановка проверяют сами */
+    bool monitor = lim && lim->progress;
+    g->stop.cancel = !monitor && g->cancel ? g->cancel : &g->halt;
+    g->part_opened = 0;
+    g->part_attempt = -1;
+    g->part_r = g->part_c = -1;
+    uint64_t fill_ns = (uint64_t)g->rows * (uint64_t)g->cols * GEN_FILL_NS_PER_CELL;
+    for (int t = 0; t < g->threads; ++t) {
+        stats_clear(&g->workers[t].stats);
+        g->workers[t].held = -1;
+        g->workers[t].fill_ns = fill_ns;
+        solver_ctx_set_stop(g->workers[t].ctx, lim ? &g->stop : NULL);
+    }
+
+    int first = monitor ? 0 : 1;
+    int started = first;
+    g->running = first;
+    for (int t = first; t < g->threads; ++t) {
+        mt_atomic_add(&g->running, 1);
+        if (!mt_thread_start(&g->workers[t].thread, pargen_worker, &g->workers[t])) {
+            mt_atomic_add(&g->running, -1);
+            break;
+        }
+        ++started;
+    }
+    if (started == 0) {
+        /* потоков нет: решаем сами, внешний флаг проверяется только между попытками */
+        g->running = 1;
+        pargen_worker(&g->workers[0]);
+        started = 1;
+        first = 1;
+    }
+    else if (monitor) pargen_monitor(g, lim, max_attempts, t_start);
+    else pargen_worker(&g->workers[0]);
+    for (int t = first; t < started; ++t) mt_thread_join(g->workers[t].thread);
+    if (g->stats)
+        for (int t = 0; t < started; ++t) stats_merge(g->stats, &g->workers[t].stats);
+    for (int t = 0; t < g->threads; ++t) solver_ctx_set_stop(g->workers[t].ctx, NULL);
+
+    long best = g->best_attempt;
+    bool ok = best < max_attempts;
+    /* без решения и остановки попытки не доиграны, только если рабочие не начали их,
+       не успевая к сроку: сам срок тогда мог ещё не наступить */
+    GenStatus status = ok ? GEN_SOLVED : g->halt != 0 ? (GenStatus)g->halt
+        : g->attempts_made < max_attempts ? GEN_NO_TIME : GEN_EXHAUSTED;
+
+    /* принятое поле восстанавливаем из его зерна: это дешевле копирования между потоками
+       и гарантирует ту же расстановку, что видел солвер; без решения — поле попытки 0
+       или, в запуске с ограничениями, лучшей частичной попытки. С ограничениями поле
+       копируется у рабочего или из part_field: расстановка большого поля дольше копии,
+       а после срока строить его заново нельзя. Если ни одна расстановка не успела к сроку,
+       out только очищается */
+    long shown = ok ? best : g->part_attempt >= 0 ? g->part_attempt : 0;
+    bool copied = false;
+    if (g->limited && !ok && g->part_attempt >= 0)
+        copied = field_copy(out, g->part_field);
+    for (int t = 0; t < g->threads && g->limited && !copied; ++t)
+        if (g->workers[t].held == shown) copied = field_copy(out, g->workers[t].field);
+    if (!copied) {
+        if (g->limited && !ok && g->part_attempt < 0) field_clear(out);
+        else if (!pargen_fill(g, out, rng_derive(seed, (uint64_t)shown), NULL, NULL)) field_clear(out);
+    }
+
+    if (res) {
+        res->solvable = ok;
+        res->attempt = ok ? (int)best : -1;
+        res->attempt_seed = rng_derive(seed, (uint64_t)shown);
+        res->start_r = ok ? g->best_r : g->limited ? g->part_r : -1;
+        res->start_c = ok ? g->best_c : g->limited ? g->part_c : -1;
+        res->attempts_made = (int)g->attempts_made;
+        res->opened = ok ? out->rows * out->cols - out->mines : g->limited ? (int)g->part_opened : -1;
+    }
+    return status;
+}
+
+bool pargen_run(ParGen* g, int percent, uint64_t seed, int max_attempts,
+    Field* out, GenResult* res) {
+    return pargen_start(g, percent, -1, seed, max_attempts, NULL, out, res) == GEN_SOLVED;
+}
+
+bool pargen_run_exact(ParGen* g, int mines, uint64_t seed, int max_attempts,
+    Field* out, GenResult* res) {
+    if (mines < 0) mines = 0;
+    return pargen_start(g, 0, mines, seed, max_attempts, NULL, out, res) == GEN_SOLVED;
+}
+
+GenStatus pargen_run_limited(ParGen* g, int percent, int mines, uint64_t seed, int max_attempts,
+    const GenLimits* limits, Field* out, GenResult* res) {
+    if (mines >= 0) percent = 0;
+    return pargen_start(g, percent, mines, seed, max_attempts, limits, out, res);
+}
@@ -0,0 +1,152 @@
+#ifndef MINES_GENERATOR_H
+#define MINES_GENERATOR_H
+
+#include "field.h"
+
+/* -------------------------------------------------------------------
+   Параллельная генерация решаемых полей.
+   Попытки (генерация + check_solvability) распределяются между рабочими потоками;
+   у каждого потока своё поле Field и свой контекст солвера SolverCtx.
+   Попытка номер i всегда строит поле из зерна rng_derive(seed, i) расстановкой
+   дескриптора поля (fdesc_place, fielddesc.h), а результатом
+   считается решаемая попытка с НАИМЕНЬШИМ номером. Поэтому итог зависит только от
+   seed и параметров поля и воспроизводим при любом числе потоков.
+   ------------------------------------------------------------------- */
+
+/* GenResult — итог одного запуска генератора */
+typedef struct {
+    bool solvable;          /* найдено ли решаемое поле */
+    int attempt;            /* номер принятой попытки (-1, если не найдено) */
+    uint64_t attempt_seed;  /* зерно, из которого построено принятое поле */
+    int start_r, start_c;   /* стартовая клетка, с которой солвер решает поле */
+    int attempts_made;      /* сколько попыток реально выполнено всеми потоками */
+    int opened;             /* сколько клеток открыл солвер в поле out (-1 — не отслеживалось) */
+} GenResult;
+
+/* GenStatus — чем закончился запуск pargen_run_limited */
+typedef enum {
+    GEN_SOLVED,             /* найдено решаемое поле */
+    GEN_EXHAUSTED,          /* все max_attempts попыток выполнены, решаемых нет (или поле не строится) */
+    GEN_TIMEOUT,            /* истёк срок */
+    GEN_CANCELLED,          /* отмена флагом или функцией прогресса */
+    GEN_NO_TIME             /* срок не истёк, но ни одна следующая попытка к нему не успела бы */
+} GenStatus;
+
+/* GenProgress — состояние запуска для функции прогресса */
+typedef struct {
+    int attempts_made;      /* завершённых попыток */
+    int max_attempts;
+    uint64_t elapsed_ns;    /* с начала запуска */
+    bool solved;            /* решаемая попытка уже найдена (доигрываются меньшие номера) */
+    int best_opened;        /* лучший частичный итог: больше всего открытых клеток (0 — пока нет) */
+} GenProgress;
+
+/* Функция прогресса: вызывается из потока pargen_run_limited; false — отменить запуск */
+typedef bool (*GenProgressFn)(void* user, const GenProgress* p);
+
+/* GenLimits — ограничения запуска pargen_run_limited; нулевые поля ничего не ограничивают */
+typedef struct {
+    uint64_t deadline_ns;   /* срок по часам mt_now_ns (mt.h); 0 — без срока */
+    volatile long* cancel;  /* внешний флаг отмены: не 0 — отменить (ставится атомарно) */
+    GenProgressFn progress; /* функция прогресса (NULL — без неё) */
+    void* user;             /* аргумент progress */
+    int progress_ms;        /* период вызова progress (<= 0 — GEN_PROGRESS_MS) */
+} GenLimits;
+
+/* Период вызова функции прогресса по умолчанию, мс */
+#define GEN_PROGRESS_MS 100
+
+/* Как часто поток запуска проверяет внешний флаг и функцию прогресса, мкс */
+#define GEN_POLL_US 1000
+
+/* Оценка расстановки с подсчётом счётчиков на клетку, нс: по ней запуск со сроком
+   не начинает первую попытку, которая заведомо не успеет (дальше — по замеру).
+   Взята с запасом вниз, чтобы на быстрой машине не отбрасывать успевающие */
+#define GEN_FILL_NS_PER_CELL 4
+
+/* ParGen — пул рабочих полей и контекстов солвера под фиксированный размер поля */
+typedef struct ParGen ParGen;
+
+/* pargen_create
+   - Выделяет рабочие поля и контексты солвера для threads потоков (0 = по числу ядер).
+   - Возвращает NULL при ошибке.
+*/
+ParGen* pargen_create(int rows, int cols, int threads);
+
+/* pargen_free
+   - Освобождает генератор. Безопасно вызывать с NULL.
+*/
+void pargen_free(ParGen* g);
+
+/* pargen_threads
+   - Число рабочих потоков генератора.
+*/
+int pargen_threads(const ParGen* g);
+
+/* pargen_set_strength
+   - Уровень рассуждений солвера во всех рабочих потоках (по умолчанию SOLVER_BASIC).
+*/
+void pargen_set_strength(ParGen* g, SolverStrength strength);
+
+/* pargen_set_start
+   - Включает генерацию под известный первый клик: окрестность 3x3 клетки
+     (start_r,start_c) без мин (fdesc_place, FDESC_FIRST_CLICK), и решаемость каждой
+     попытки проверяется одним запуском солвера из этой клетки.
+   - Координаты вне поля (например -1, -1) возвращают обычный перебор стартов.
+*/
+void pargen_set_start(ParGen* g, int start_r, int start_c);
+
+/* pargen_set_stats
+   - Каждый следующий запуск добавляет в stats счётчики попыток и солвера и время
+     по фазам (расстановка, счётчики, решение), сложенные по всем потокам.
+   - NULL отключает сбор. Без FIELD_STATS при сборке stats остаётся нулевой.
+*/
+void pargen_set_stats(ParGen* g, GenStats* stats);
+
+/* pargen_run
+   - Выполняет до max_attempts попыток генерации с вероятностью мин percent.
+   - res->opened: число безопасных клеток при успехе, -1 при неудаче.
+   - Поле описывается дескриптором: fdesc_init с теми же параметрами и fdesc_set_result(res).
+   - Первая найденная решаемая попытка отменяет попытки с большими номерами;
+     попытки с меньшими номерами доигрываются, чтобы результат был детерминированным.
+   - При успехе принятое поле записывается в out (размеры out должны совпадать)
+     и функция возвращает true; иначе в out записывается поле попытки 0 (для анализа).
+*/
+bool pargen_run(ParGen* g, int percent, uint64_t seed, int max_attempts,
+    Field* out, GenResult* res);
+
+/* pargen_run_exact
+   - То же, что pargen_run, но каждая попытка ставит ровно mines мин (выборка Флойда, как generate_exact_rng).
+   - mines больше, чем клеток поля (вне окрестности 3x3 при pargen_set_start), — ошибка:
+     false (GEN_EXHAUSTED) без попыток, res->attempts_made == 0, out не меняется.
+*/
+bool pargen_run_exact(ParGen* g, int mines, uint64_t seed, int max_attempts,
+    Field* out, GenResult* res);
+
+/* pargen_run_limited
+   - То же, что pargen_run (mines >= 0 — как pargen_run_exact), но с ограничениями limits
+     (NULL — без ограничений, и результат совпадает с pargen_run).
+   - Срок и флаг отмены проверяются рабочими потоками перед каждой попыткой, внутри
+     расстановки и подсчёта счётчиков (раз в FIELD_STOP_CELLS клеток), после них и
+     внутри солвера (solver_ctx_set_stop: check_solvability_ctx и цикл
+     распространения), поэтому функция возвращается в пределах нескольких миллисекунд
+     после срока.
+   - Расстановку, которая заведомо не успеет, рабочий не начинает: первую оценивает
+     по GEN_FILL_NS_PER_CELL на клетку, следующие — по замеру своей прошлой. Если так
+     остановились все рабочие, запуск возвращается до срока с GEN_NO_TIME (итог в out
+     и res — как у GEN_TIMEOUT); GEN_TIMEOUT означает, что срок действительно истёк.
+     Флаг cancel проверяется там же, где срок. С progress вызывающий поток не решает
+     поля сам, а раз в GEN_POLL_US проверяет флаг и раз в progress_ms вызывает progress.
+   - GEN_SOLVED: решаемое поле в out, как у pargen_run. Если запуск прерван, когда
+     решаемая попытка уже была, возвращается она, хотя попытки с меньшими номерами
+     могли не доиграться: поле по-прежнему восстанавливается по res (attempt_seed).
+   - Иначе в out — лучший частичный итог: попытка, в которой солвер открыл больше всего
+     клеток (res->attempt_seed, старт res->start_r/start_c, res->opened);
+     res->attempt == -1. Если ни одна расстановка не успела к сроку, out только очищается
+     (без мин), а res — попытка 0 и opened 0: поле строится по attempt_seed.
+   - res->attempts_made считает только попытки, доведённые до конца.
+*/
+GenStatus pargen_run_limited(ParGen* g, int percent, int mines, uint64_t seed, int max_attempts,
+    const GenLimits* limits, Field* out, GenResult* res);
+
+#endif /* MINES_GENERATOR_H */
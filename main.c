@@ -1,4 +1,8 @@
 #include "field.h"
+#include "generator.h"
+#include "batch.h"
+#include "service.h"
+#include "calib.h"
 #include <locale.h>
 #include <stdio.h>
 #include <time.h>
@@ -6,14 +10,55 @@
 /* Максимальное число попыток найти решение.*/
 #define MAX_ATTEMPTS 1000
 
+/* Таблица калибровки (calib.h): доля решаемых попыток по прошлым генерациям */
+#define CALIB_FILE "mines_calib.txt"
+
+/* Уровень рассуждений солвера: SOLVER_SUBSET дополнительно решает шаблоны 1-2, 1-2-1,
+   поэтому решаемое поле находится за меньшее число попыток. */
+#define SOLVER_STRENGTH SOLVER_SUBSET
+
 /* ===================================================================
    Основной цикл программы и пользовательский интерфейс
    =================================================================== */
 
-int main(void) {
+/* План по калибровке для введённых параметров: бюджет попыток в *budget.
+   На безнадёжных параметрах генерация не запускается, а пользователю предлагается
+   ближайшая плотность с решаемыми полями (она записывается в *perc).
+   Возвращает 'G' — генерировать, 'P' — ввести новые параметры, 'E' — выйти. */
+static int calib_ask(const CalibTable* calib, int rows, int cols, int* perc, int* budget) {
+    for (;;) {
+        CalibPlan plan;
+        calib_plan(calib, rows, cols, *perc, SOLVER_STRENGTH, false, MAX_ATTEMPTS, &plan);
+        *budget = plan.attempts;
+        if (plan.verdict != CALIB_INFEASIBLE) return 'G';
+
+        calib_print_plan(&plan, *perc, stdout);
+        if (plan.suggest_percent >= 0) printf("(S) взять %d%%, ", plan.suggest_percent);
+        printf("(A) всё равно попробовать %d попыток, (P) новые параметры, (E) выйти\n", MAX_ATTEMPTS);
+        int ch = getchar();
+        while (getchar() != '\n');
+
+        if ((ch == 'S' || ch == 's') && plan.suggest_percent >= 0) { *perc = plan.suggest_percent; continue; }
+        if (ch == 'A' || ch == 'a') { *budget = MAX_ATTEMPTS; return 'G'; }
+        if (ch == 'P' || ch == 'p') return 'P';
+        return 'E';
+    }
+}
+
+int main(int argc, char** argv) {
     setlocale(LC_ALL, "Rus");
-    /* инициализация RNG */
-    srand((unsigned)time(NULL));
+
+    /* --serve — сервис с пулами готовых полей (service.h) */
+    if (argc > 1 && strcmp(argv[1], "--serve") == 0) return run_service(argc, argv);
+    /* с аргументами командной строки — пакетный режим без диалога */
+    if (argc > 1) return run_batch(argc, argv);
+
+    /* инициализация RNG: из master_rng берутся зёрна для каждой генерации */
+    Rng master_rng;
+    rng_seed(&master_rng, (uint64_t)time(NULL));
+
+    /* калибровка копится между запусками программы; без памяти — работаем без неё */
+    CalibTable* calib = calib_load(CALIB_FILE);
 
     printf("Здравствуйте! Это генератор поля Сапёр (Mines generator).\n");
 
@@ -28,36 +73,50 @@ int main(void) {
         printf("Введите вероятность заполнения минами (0..100), например: 15\n");
         while (getchar() != '\n');
 
+        /* ---------- Бюджет попыток по калибровке ---------- */
+        int attempts = MAX_ATTEMPTS;
+        int decision = calib_ask(calib, rows, cols, &perc, &attempts);
+        if (decision == 'P') continue;
+        if (decision == 'E') { calib_free(calib); printf("Выход.\n"); return 0; }
+
         /* Создаём поле нужного размера */
         Field* field = field_create(rows, cols);
-        if (!field) { printf("Ошибка выделения памяти.\n"); return 1; }
+        if (!field) { calib_free(calib); printf("Ошибка выделения памяти.\n"); return 1; }
+
+        /* Параллельный генератор: рабочие поля и контексты солвера для каждого потока
+           выделяются один раз на размер поля и переиспользуются во всех попытках */
+        ParGen* gen = pargen_create(rows, cols, 0);
+        if (!gen) { field_free(field); calib_free(calib); printf("Ошибка выделения памяти.\n"); return 1; }
+        pargen_set_strength(gen, SOLVER_STRENGTH);
+        /* при сборке с FIELD_STATS после каждой генерации печатается статистика */
+        GenStats stats;
+        if (stats_enabled()) pargen_set_stats(gen, &stats);
 
     /* ---- Попытки сгенерировать решаемую конфигурацию поля ----
-        Выполняется до MAX_ATTEMPTS попыток. Каждая попытка:
+        Выполняется до attempts попыток (MAX_ATTEMPTS или меньше, если по калибровке
+        доля решаемых известна), распределённых по всем ядрам. Каждая попытка:
             - очищает текущее состояние поля,
             - заново случайно размещает мины,
             - пересчитывает числовые счётчики,
             - проверяет решаемость детерминистическим солвером.
         Память под структуру Field выделяется один раз;
-        изменяется только содержимое поля.
-        Если за MAX_ATTEMPTS попыток решаемая конфигурация не найдена,
+        изменяется только содержимое поля. Первая решаемая попытка отменяет
+        оставшиеся; результат воспроизводим по зерну seed.
+        Если за attempts попыток решаемая конфигурация не найдена,
         считается, что с данными параметрами (rows, cols, perc)
         быстро получить решаемое поле не удалось.
         В этом случае пользователю предлагается выбор дальнейших действий.
     */
     generate_again:
         {
-            bool solvable = false;
-            int start_r = -1, start_c = -1;
-
-
-            for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-                generate_by_probability(field, perc);
-                if (check_solvability(field, &start_r, &start_c)) {
-                    solvable = true; /* нашли подходящее поле */
-                    break;
-                }
-            }
+            GenResult res;
+            uint64_t seed = rng_next(&master_rng);
+            stats_clear(&stats);
+            bool solvable = pargen_run(gen, perc, seed, attempts, field, &res);
+            calib_record(calib, rows, cols, perc, SOLVER_STRENGTH, false, calib_trials(&res), solvable ? 1 : 0);
+            if (calib && !calib_save(calib, CALIB_FILE))
+                printf("Не удалось сохранить калибровку в %s.\n", CALIB_FILE);
+            if (stats_enabled()) stats_print(&stats, stdout);
 
             /* Показываем информацию о сгенерированном поле */
             printf("\nСгенерировано поле %dx%d, вероятность %d%%, мин = %d\n",
@@ -83,11 +142,11 @@ int main(void) {
                     goto generate_again;
                 }
                 if (opt == 'P' || opt == 'p') {
-                    field_free(field);
+                    field_free(field); pargen_free(gen);
                     continue;  /* вернуться к вводу размеров и вероятности */
                 }
                 /* E или любое другое — выход */
-                field_free(field);
+                field_free(field); pargen_free(gen); calib_free(calib);
                 printf("Выход.\n");
                 return 0;
             }
@@ -104,11 +163,11 @@ int main(void) {
                     goto generate_again;
                 }
                 if (choice == 'P' || choice == 'p') {
-                    field_free(field);
+                    field_free(field); pargen_free(gen);
                     continue;
                 }
                 if (choice == 'E' || choice == 'e') {
-                    field_free(field);
+                    field_free(field); pargen_free(gen); calib_free(calib);
                     printf("Выход.\n");
                     return 0;
                 }
@@ -123,8 +182,8 @@ int main(void) {
                         int o2 = getchar();
                         while (getchar() != '\n');
                         if (o2 == 'R' || o2 == 'r') { field_clear(field); goto generate_again; }
-                        if (o2 == 'P' || o2 == 'p') { field_free(field); continue; }
-                        field_free(field); printf("Выход.\n"); return 0;
+                        if (o2 == 'P' || o2 == 'p') { field_free(field); pargen_free(gen); continue; }
+                        field_free(field); pargen_free(gen); calib_free(calib); printf("Выход.\n"); return 0;
                     }
                     else {
                         /* Сохранение поля */
@@ -149,8 +208,8 @@ int main(void) {
                                 printf("Неверный ввод.\n");
                                 continue;
                             }
-                            if (cmd == 1) { field_free(field); break; } /* начать новый цикл */
-                            else if (cmd == 2) { field_free(field); printf("Выход.\n"); return 0; }
+                            if (cmd == 1) { field_free(field); pargen_free(gen); break; } /* начать новый цикл */
+                            else if (cmd == 2) { field_free(field); pargen_free(gen); calib_free(calib); printf("Выход.\n"); return 0; }
                             else printf("Неизвестная команда.\n");
                         }
                         continue; /* вернуться к внешнему циклу, предложить новые параметры */
@@ -159,7 +218,7 @@ int main(void) {
             }
         }
 
-        field_free(field);
+        field_free(field); pargen_free(gen);
     }
 
     return 0;
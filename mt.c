@@ -0,0 +1,231 @@
+#include "mt.h"
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/* Аргумент-переходник: приводит mt_func к сигнатуре функции потока ОС */
+typedef struct {
+    mt_func fn;
+    void* arg;
+} MtStart;
+
+#ifdef _WIN32
+
+static DWORD WINAPI mt_trampoline(LPVOID p) {
+    MtStart s = *(MtStart*)p;
+    free(p);
+    s.fn(s.arg);
+    return 0;
+}
+
+bool mt_thread_start(mt_thread* t, mt_func fn, void* arg) {
+    MtStart* s = (MtStart*)malloc(sizeof(MtStart));
+    if (!s) return false;
+    s->fn = fn;
+    s->arg = arg;
+    *t = CreateThread(NULL, 0, mt_trampoline, s, 0, NULL);
+    if (!*t) { free(s); return false; }
+    return true;
+}
+
+void mt_thread_join(mt_thread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+void mt_mutex_init(mt_mutex* m) { InitializeCriticalSection(m); }
+void mt_mutex_destroy(mt_mutex* m) { DeleteCriticalSection(m); }
+void mt_mutex_lock(mt_mutex* m) { EnterCriticalSection(m); }
+void mt_mutex_unlock(mt_mutex* m) { LeaveCriticalSection(m); }
+
+void mt_cond_init(mt_cond* c) { InitializeConditionVariable(c); }
+void mt_cond_destroy(mt_cond* c) { (void)c; }
+void mt_cond_wait(mt_cond* c, mt_mutex* m) { SleepConditionVariableCS(c, m, INFINITE); }
+void mt_cond_broadcast(mt_cond* c) { WakeAllConditionVariable(c); }
+
+void mt_yield(void) { SwitchToThread(); }
+
+void mt_sleep_us(unsigned us) { Sleep((us + 999) / 1000); }
+
+int mt_cpu_count(void) {
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+}
+
+uint64_t mt_now_ns(void) {
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER t;
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    /* делим по частям, чтобы не переполнить 64 бита на больших значениях счётчика */
+    return (uint64_t)(t.QuadPart / freq.QuadPart) * 1000000000ULL
+         + (uint64_t)(t.QuadPart % freq.QuadPart) * 1000000000ULL / (uint64_t)freq.QuadPart;
+}
+
+long mt_atomic_load(volatile long* p) { return InterlockedCompareExchange(p, 0, 0); }
+void mt_atomic_store(volatile long* p, long v) { InterlockedExchange(p, v); }
+long mt_atomic_add(volatile long* p, long v) { return InterlockedExchangeAdd(p, v); }
+bool mt_atomic_cas(volatile long* p, long expected, long desired) {
+    return InterlockedCompareExchange(p, desired, expected) == expected;
+}
+
+#else
+
+static void* mt_trampoline(void* p) {
+    MtStart s = *(MtStart*)p;
+    free(p);
+    s.fn(s.arg);
+    return NULL;
+}
+
+bool mt_thread_start(mt_thread* t, mt_func fn, void* arg) {
+    MtStart* s = (MtStart*)malloc(sizeof(MtStart));
+    if (!s) return false;
+    s->fn = fn;
+    s->arg = arg;
+    if (pthread_create(t, NULL, mt_trampoline, s) != 0) { free(s); return false; }
+    return true;
+}
+
+void mt_thread_join(mt_thread t) { pthread_join(t, NULL); }
+
+void mt_mutex_init(mt_mutex* m) { pthread_mutex_init(m, NULL); }
+void mt_mutex_destroy(mt_mutex* m) { pthread_mutex_destroy(m); }
+void mt_mutex_lock(mt_mutex* m) { pthread_mutex_lock(m); }
+void mt_mutex_unlock(mt_mutex* m) { pthread_mutex_unlock(m); }
+
+void mt_cond_init(mt_cond* c) { pthread_cond_init(c, NULL); }
+void mt_cond_destroy(mt_cond* c) { pthread_cond_destroy(c); }
+void mt_cond_wait(mt_cond* c, mt_mutex* m) { pthread_cond_wait(c, m); }
+void mt_cond_broadcast(mt_cond* c) { pthread_cond_broadcast(c); }
+
+void mt_yield(void) { sched_yield(); }
+
+void mt_sleep_us(unsigned us) {
+    struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+int mt_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+uint64_t mt_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+long mt_atomic_load(volatile long* p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+void mt_atomic_store(volatile long* p, long v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+long mt_atomic_add(volatile long* p, long v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+bool mt_atomic_cas(volatile long* p, long expected, long desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#endif
+
+/* ---------- Пул потоков ----------
+   Задачи раздаются атомарным счётчиком next; каждое новое задание пула получает
+   свой номер generation, по которому спящие рабочие узнают, что пора работать. */
+struct MtPool {
+    int threads;                /* вместе с вызывающим потоком */
+    mt_thread* workers;
+    mt_mutex lock;
+    mt_cond wake;               /* новое задание или завершение пула */
+    mt_cond done;               /* все рабочие закончили задание */
+    mt_task fn;
+    void* arg;
+    int tasks;
+    volatile long next;
+    int active;                 /* рабочих, ещё не закончивших текущее задание */
+    unsigned long generation;
+    bool quit;
+};
+
+static void mt_pool_drain(MtPool* p) {
+    long i;
+    while ((i = mt_atomic_add(&p->next, 1)) < p->tasks) p->fn(p->arg, (int)i);
+}
+
+static void mt_pool_worker(void* arg) {
+    MtPool* p = (MtPool*)arg;
+    unsigned long seen = 0;
+    for (;;) {
+        mt_mutex_lock(&p->lock);
+        while (p->generation == seen && !p->quit) mt_cond_wait(&p->wake, &p->lock);
+        if (p->quit) { mt_mutex_unlock(&p->lock); return; }
+        seen = p->generation;
+        mt_mutex_unlock(&p->lock);
+
+        mt_pool_drain(p);
+
+        mt_mutex_lock(&p->lock);
+        if (--p->active == 0) mt_cond_broadcast(&p->done);
+        mt_mutex_unlock(&p->lock);
+    }
+}
+
+MtPool* mt_pool_create(int threads) {
+    if (threads <= 0) threads = mt_cpu_count();
+    MtPool* p = (MtPool*)calloc(1, sizeof(MtPool));
+    if (!p) return NULL;
+    mt_mutex_init(&p->lock);
+    mt_cond_init(&p->wake);
+    mt_cond_init(&p->done);
+    p->threads = 1;
+    p->workers = (mt_thread*)malloc((size_t)threads * sizeof(mt_thread));
+    if (!p->workers) { mt_pool_free(p); return NULL; }
+    for (int t = 1; t < threads; ++t) {
+        if (!mt_thread_start(&p->workers[t - 1], mt_pool_worker, p)) break;
+        ++p->threads;
+    }
+    return p;
+}
+
+void mt_pool_free(MtPool* p) {
+    if (!p) return;
+    mt_mutex_lock(&p->lock);
+    p->quit = true;
+    mt_cond_broadcast(&p->wake);
+    mt_mutex_unlock(&p->lock);
+    for (int t = 0; t < p->threads - 1; ++t) mt_thread_join(p->workers[t]);
+    free(p->workers);
+    mt_cond_destroy(&p->wake);
+    mt_cond_destroy(&p->done);
+    mt_mutex_destroy(&p->lock);
+    free(p);
+}
+
+int mt_pool_threads(const MtPool* p) {
+    return p ? p->threads : 1;
+}
+
+void mt_pool_run(MtPool* p, mt_task fn, void* arg, int tasks) {
+    if (!fn || tasks <= 0) return;
+    if (!p || p->threads == 1) {
+        for (int i = 0; i < tasks; ++i) fn(arg, i);
+        return;
+    }
+    mt_mutex_lock(&p->lock);
+    p->fn = fn;
+    p->arg = arg;
+    p->tasks = tasks;
+    p->next = 0;
+    p->active = p->threads - 1;
+    ++p->generation;
+    mt_cond_broadcast(&p->wake);
+    mt_mutex_unlock(&p->lock);
+
+    mt_pool_drain(p); /* вызывающий поток работает наравне с пулом */
+
+    mt_mutex_lock(&p->lock);
+    while (p->active > 0) mt_cond_wait(&p->done, &p->lock);
+    mt_mutex_unlock(&p->lock);
+}
@@ -0,0 +1,102 @@
+#ifndef MINES_MT_H
+#define MINES_MT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* -------------------------------------------------------------------
+   Минимальная переносимая обёртка над потоками и атомарными операциями:
+   Win32 API под MSVC и pthreads / встроенные атомики GCC/Clang под Linux.
+   ------------------------------------------------------------------- */
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+typedef HANDLE mt_thread;
+typedef CRITICAL_SECTION mt_mutex;
+typedef CONDITION_VARIABLE mt_cond;
+#else
+#include <pthread.h>
+typedef pthread_t mt_thread;
+typedef pthread_mutex_t mt_mutex;
+typedef pthread_cond_t mt_cond;
+#endif
+
+/* Функция потока: получает произвольный аргумент */
+typedef void (*mt_func)(void* arg);
+
+/* mt_thread_start / mt_thread_join
+   - Запускает поток, выполняющий fn(arg). Возвращает false при ошибке.
+   - mt_thread_join ждёт завершения потока и освобождает его ресурсы.
+*/
+bool mt_thread_start(mt_thread* t, mt_func fn, void* arg);
+void mt_thread_join(mt_thread t);
+
+/* Мьютекс (для редких событий; горячий путь использует атомики) */
+void mt_mutex_init(mt_mutex* m);
+void mt_mutex_destroy(mt_mutex* m);
+void mt_mutex_lock(mt_mutex* m);
+void mt_mutex_unlock(mt_mutex* m);
+
+/* Условная переменная: ожидание под мьютексом m и пробуждение ждущих */
+void mt_cond_init(mt_cond* c);
+void mt_cond_destroy(mt_cond* c);
+void mt_cond_wait(mt_cond* c, mt_mutex* m);
+void mt_cond_broadcast(mt_cond* c);
+
+/* mt_yield
+   - Уступает процессор другим потокам (для циклов ожидания).
+*/
+void mt_yield(void);
+
+/* mt_sleep_us
+   - Засыпает примерно на us микросекунд (в Windows — с точностью таймера системы).
+*/
+void mt_sleep_us(unsigned us);
+
+/* mt_cpu_count
+   - Число логических процессоров (не меньше 1).
+*/
+int mt_cpu_count(void);
+
+/* mt_now_ns
+   - Монотонное время в наносекундах (для замеров; начало отсчёта не определено).
+*/
+uint64_t mt_now_ns(void);
+
+/* Атомарные операции над long (последовательная согласованность)
+   - mt_atomic_add возвращает значение ДО прибавления.
+   - mt_atomic_cas записывает desired, если *p == expected, и возвращает true при успехе.
+*/
+long mt_atomic_load(volatile long* p);
+void mt_atomic_store(volatile long* p, long v);
+long mt_atomic_add(volatile long* p, long v);
+bool mt_atomic_cas(volatile long* p, long expected, long desired);
+
+/* MtPool — постоянные рабочие потоки для коротких параллельных проходов
+   (потоки создаются один раз, а не на каждый вызов) */
+typedef struct MtPool MtPool;
+
+/* Задача номер index из mt_pool_run */
+typedef void (*mt_task)(void* arg, int index);
+
+/* mt_pool_create / mt_pool_free
+   - Пул из threads потоков (0 = по числу ядер); вызывающий поток считается одним
+     из них, поэтому создаётся threads - 1 рабочих. Возвращает NULL при ошибке.
+*/
+MtPool* mt_pool_create(int threads);
+void mt_pool_free(MtPool* p);
+
+/* mt_pool_threads
+   - Сколько потоков (вместе с вызывающим) выполняют задачи.
+*/
+int mt_pool_threads(const MtPool* p);
+
+/* mt_pool_run
+   - Выполняет fn(arg, 0..tasks-1) на всех потоках пула и ждёт завершения всех задач.
+   - p == NULL — все задачи выполняются в вызывающем потоке.
+*/
+void mt_pool_run(MtPool* p, mt_task fn, void* arg, int tasks);
+
+#endif /* MINES_MT_H */
@@ -0,0 +1,147 @@
+#include "parfield.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Разбиение на полосы: по несколько полос на поток, чтобы выровнять нагрузку,
+   но не мельче PARFIELD_MIN_BAND_CELLS клеток */
+static int parfield_bands(const Field* f, const MtPool* pool) {
+    int threads = mt_pool_threads(pool);
+    if (threads <= 1) return 1;
+    long long cells = (long long)f->rows * f->cols;
+    long long bands = cells / PARFIELD_MIN_BAND_CELLS;
+    if (bands > (long long)threads * 4) bands = (long long)threads * 4;
+    if (bands > f->rows) bands = f->rows;
+    return bands < 1 ? 1 : (int)bands;
+}
+
+/* Строки полосы i из n: [r0, r1) */
+static void parfield_band_rows(const Field* f, int i, int n, int* r0, int* r1) {
+    *r0 = (int)((long long)f->rows * i / n);
+    *r1 = (int)((long long)f->rows * (i + 1) / n);
+}
+
+/* ---------- compute_counts ---------- */
+
+typedef struct {
+    Field* f;
+    int bands;
+} CountsJob;
+
+static void counts_task(void* arg, int i) {
+    CountsJob* job = (CountsJob*)arg;
+    int r0, r1;
+    parfield_band_rows(job->f, i, job->bands, &r0, &r1);
+    compute_counts_rows(job->f, r0, r1);
+}
+
+void compute_counts_mt(Field* f, MtPool* pool) {
+    if (!f) return;
+    CountsJob job = { f, parfield_bands(f, pool) };
+    if (job.bands == 1) { compute_counts(f); return; }
+    mt_pool_run(pool, counts_task, &job, job.bands);
+}
+
+/* ---------- Проверка счётчиков ---------- */
+
+/* Буфер ошибок одной полосы */
+typedef struct {
+    FieldError* items;
+    size_t count, cap;
+    long long total;
+    bool failed;            /* не хватило памяти: список полосы неполон */
+} BandErrors;
+
+typedef struct {
+    const Field* f;
+    int bands;
+    size_t limit;           /* полоса не знает о соседних, поэтому хранит до limit своих */
+    BandErrors* out;
+} ValidateJob;
+
+static void band_push(BandErrors* b, size_t limit, int r, int c, int have, int expected) {
+    ++b->total;
+    if (b->failed || b->count >= limit) return;
+    if (b->count == b->cap) {
+        size_t cap = b->cap ? b->cap * 2 : 16;
+        if (cap > limit) cap = limit;
+        FieldError* p = (FieldError*)realloc(b->items, cap * sizeof(FieldError));
+        if (!p) { b->failed = true; return; } /* дальше только счёт: список уже не первые записи */
+        b->items = p;
+        b->cap = cap;
+    }
+    FieldError* e = &b->items[b->count++];
+    e->r = r;
+    e->c = c;
+    e->have = have;
+    e->expected = expected;
+}
+
+static void validate_band(const Field* f, int r0, int r1, size_t limit, BandErrors* b) {
+    const int* nb = f->nbr;
+    for (int r = r0; r < r1; ++r) {
+        const unsigned char* m = f->is_mine + IDX(f, r, 0);
+        const unsigned char* cnt = f->count + IDX(f, r, 0);
+        for (int c = 0; c < f->cols; ++c) {
+            if (m[c]) continue;
+            int n = m[c + nb[0]] + m[c + nb[1]] + m[c + nb[2]] + m[c + nb[3]]
+                + m[c + nb[4]] + m[c + nb[5]] + m[c + nb[6]] + m[c + nb[7]];
+            if (n != cnt[c]) band_push(b, limit, r, c, cnt[c], n);
+        }
+    }
+}
+
+static void validate_task(void* arg, int i) {
+    ValidateJob* job = (ValidateJob*)arg;
+    int r0, r1;
+    parfield_band_rows(job->f, i, job->bands, &r0, &r1);
+    validate_band(job->f, r0, r1, job->limit, &job->out[i]);
+}
+
+long long validate_field_mt(const Field* f, MtPool* pool, FieldErrors* out, size_t limit) {
+    if (out) memset(out, 0, sizeof(*out));
+    if (!f) return -1;
+    if (!out) limit = 0;
+
+    ValidateJob job = { f, parfield_bands(f, pool), limit, NULL };
+    job.out = (BandErrors*)calloc((size_t)job.bands, sizeof(BandErrors));
+    if (!job.out) return -1;
+    if (job.bands == 1) validate_task(&job, 0);
+    else mt_pool_run(pool, validate_task, &job, job.bands);
+
+    /* склейка: полосы идут по порядку строк, поэтому список упорядочен */
+    long long total = 0;
+    size_t kept = 0;
+    bool failed = false;
+    for (int i = 0; i < job.bands; ++i) {
+        total += job.out[i].total;
+        kept += job.out[i].count;
+        failed |= job.out[i].failed;
+    }
+    if (kept > limit) kept = limit;
+    if (out && kept > 0 && !failed) {
+        out->items = (FieldError*)malloc(kept * sizeof(FieldError));
+        failed = !out->items;
+        for (int i = 0; out->items && i < job.bands && out->count < kept; ++i) {
+            size_t n = job.out[i].count;
+            if (n > kept - out->count) n = kept - out->count;
+            memcpy(out->items + out->count, job.out[i].items, n * sizeof(FieldError));
+            out->count += n;
+        }
+    }
+    if (out) out->total = total;
+
+    for (int i = 0; i < job.bands; ++i) free(job.out[i].items);
+    free(job.out);
+    if (failed) {
+        /* неполный список не выдаём: обещан ровно первый limit записей */
+        field_errors_free(out);
+        return -1;
+    }
+    return total;
+}
+
+void field_errors_free(FieldErrors* e) {
+    if (!e) return;
+    free(e->items);
+    memset(e, 0, sizeof(*e));
+}
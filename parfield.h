@@ -0,0 +1,51 @@
+#ifndef MINES_PARFIELD_H
+#define MINES_PARFIELD_H
+
+#include "field.h"
+#include "mt.h"
+#include <stddef.h>
+
+/* -------------------------------------------------------------------
+   Многопоточные compute_counts и проверка счётчиков.
+   Оба ядра — стенсил 3x3 без зависимостей между строками, поэтому поле
+   режется на полосы строк, которые разбирают потоки MtPool. Каждая полоса
+   пишет только свои строки (count) или свой буфер ошибок, блокировок нет.
+   Маленькие поля (меньше PARFIELD_MIN_BAND_CELLS клеток на полосу) и
+   pool == NULL считаются в вызывающем потоке.
+   ------------------------------------------------------------------- */
+
+/* Минимум клеток в полосе: меньше — накладные расходы пула дороже работы */
+#define PARFIELD_MIN_BAND_CELLS (1 << 16)
+
+/* Несоответствие счётчика: в клетке (r,c) записано have, а соседних мин expected */
+typedef struct {
+    int r, c;
+    int have;
+    int expected;
+} FieldError;
+
+/* Список ошибок в порядке строк (и столбцов внутри строки) */
+typedef struct {
+    FieldError* items;
+    size_t count;           /* записей в items (не больше limit) */
+    long long total;        /* всего несоответствий на поле */
+} FieldErrors;
+
+/* compute_counts_mt
+   - То же, что compute_counts, полосами строк на потоках pool.
+*/
+void compute_counts_mt(Field* f, MtPool* pool);
+
+/* validate_field_mt
+   - Проверка счётчиков как в validate_field, но без печати: полосы собирают
+     несоответствия в свои буферы, после прохода буферы склеиваются по порядку
+     полос в out (первые limit записей; out может быть NULL — только подсчёт).
+   - Возвращает число несоответствий (0 — поле корректно, -1 — f == NULL или не хватило
+     памяти на список; тогда out пуст).
+   - Список освобождается field_errors_free.
+*/
+long long validate_field_mt(const Field* f, MtPool* pool, FieldErrors* out, size_t limit);
+
+void field_errors_free(FieldErrors* e);
+
+#endif /* MINES_PARFIELD_H */
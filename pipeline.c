@@ -0,0 +1,262 @@
+#include "pipeline.h"
+#include "mt.h"
+
+/* Ёмкость очереди готовых полей по умолчанию */
+#define PIPE_QUEUE_DEFAULT 64
+
+/* Ожидание пустой/полной очереди: сначала PIPE_SPINS уступок процессора,
+   затем сон, удваивающийся до PIPE_SLEEP_MAX_US (поток не крутится вхолостую,
+   пока генерируется большое поле) */
+#define PIPE_SPINS 64
+#define PIPE_SLEEP_MIN_US 20
+#define PIPE_SLEEP_MAX_US 1000
+
+/* ---------- Ограниченная lock-free очередь MPMC (Вьюков) ----------
+   Каждая ячейка хранит номер последовательности: ячейка свободна для записи
+   позиции pos, если seq == pos, и готова к чтению, если seq == pos + 1. */
+typedef struct {
+    volatile long seq;
+    void* data;
+} PipeCell;
+
+typedef struct {
+    PipeCell* cells;
+    long mask;              /* ёмкость - 1, ёмкость — степень двойки */
+    volatile long head;     /* следующая позиция чтения */
+    volatile long tail;     /* следующая позиция записи */
+} PipeQueue;
+
+/* Разность счётчиков без знакового переполнения при их циклическом переходе */
+static long pipe_diff(long a, long b) {
+    return (long)((unsigned long)a - (unsigned long)b);
+}
+
+static bool pipe_queue_init(PipeQueue* q, long min_cap) {
+    long cap = 1;
+    while (cap < min_cap) cap <<= 1;
+    q->cells = (PipeCell*)malloc((size_t)cap * sizeof(PipeCell));
+    if (!q->cells) return false;
+    for (long i = 0; i < cap; ++i) q->cells[i].seq = i;
+    q->mask = cap - 1;
+    q->head = q->tail = 0;
+    return true;
+}
+
+/* Возвращает false, если очередь полна */
+static bool pipe_push(PipeQueue* q, void* v) {
+    long pos = mt_atomic_load(&q->tail);
+    for (;;) {
+        PipeCell* cell = &q->cells[pos & q->mask];
+        long d = pipe_diff(mt_atomic_load(&cell->seq), pos);
+        if (d == 0) {
+            if (mt_atomic_cas(&q->tail, pos, pipe_diff(pos, -1))) {
+                cell->data = v;
+                mt_atomic_store(&cell->seq, pipe_diff(pos, -1));
+                return true;
+            }
+            pos = mt_atomic_load(&q->tail);
+        }
+        else if (d < 0) return false;
+        else pos = mt_atomic_load(&q->tail);
+    }
+}
+
+/* Возвращает NULL, если очередь пуста */
+static void* pipe_pop(PipeQueue* q) {
+    long pos = mt_atomic_load(&q->head);
+    for (;;) {
+        PipeCell* cell = &q->cells[pos & q->mask];
+        long d = pipe_diff(mt_atomic_load(&cell->seq), pipe_diff(pos, -1));
+        if (d == 0) {
+            if (mt_atomic_cas(&q->head, pos, pipe_diff(pos, -1))) {
+                void* v = cell->data;
+                mt_atomic_store(&cell->seq, pipe_diff(pos, -q->mask - 1));
+                return v;
+            }
+            pos = mt_atomic_load(&q->head);
+        }
+        else if (d < 0) return NULL;
+        else pos = mt_atomic_load(&q->head);
+    }
+}
+
+/* Одно ожидание; *round — сколько раз подряд уже ждали (сбрасывается после успеха) */
+static void pipe_backoff(int* round) {
+    if (*round < PIPE_SPINS) {
+        ++*round;
+        mt_yield();
+        return;
+    }
+    unsigned us = (unsigned)PIPE_SLEEP_MIN_US << (*round - PIPE_SPINS);
+    if (us >= PIPE_SLEEP_MAX_US) us = PIPE_SLEEP_MAX_US;
+    else ++*round;
+    mt_sleep_us(us);
+}
+
+/* ---------- Конвейер ---------- */
+
+/* Элемент пула: поле и результат его генерации */
+typedef struct {
+    Field* field;
+    uint64_t index;
+    GenResult res;
+    uint64_t ns;
+} PipeItem;
+
+typedef struct Pipe Pipe;
+
+typedef struct {
+    Pipe* owner;
+    ParGen* gen;
+    SolverCtx* ctx;         /* для generate_repair (NULL без repair_rounds) */
+    mt_thread thread;
+    GenStats stats;
+} PipeWorker;
+
+struct Pipe {
+    const PipeParams* p;
+    PipeQueue ready;        /* готовые поля: рабочие -> писатель */
+    PipeQueue free_items;   /* пул свободных полей: писатель -> рабочие */
+    volatile long next_index;
+    volatile long stop;
+};
+
+/* Поле с починкой: одна "попытка" из зерна seed, итог в терминах GenResult */
+static void pipe_repair(PipeWorker* w, uint64_t seed, PipeItem* it) {
+    const PipeParams* p = w->owner->p;
+    Rng g;
+    rng_seed(&g, seed);
+    bool ok = generate_repair(it->field, w->ctx, p->percent, p->mines, p->start_r, p->start_c,
+        p->repair_rounds, &g, NULL);
+    STAT_ADD(w->ctx->stats, attempts, 1);
+    STAT_ADD(w->ctx->stats, solvable, ok);
+    it->res.solvable = ok;
+    it->res.attempt = ok ? 0 : -1;
+    it->res.attempt_seed = seed;
+    it->res.start_r = p->start_r;
+    it->res.start_c = p->start_c;
+    it->res.attempts_made = 1;
+    it->res.opened = ok ? it->field->rows * it->field->cols - it->field->mines : w->ctx->opened;
+}
+
+static void pipe_worker(void* arg) {
+    PipeWorker* w = (PipeWorker*)arg;
+    Pipe* pp = w->owner;
+    const PipeParams* p = pp->p;
+    int wait = 0;
+
+    while (!mt_atomic_load(&pp->stop)) {
+        /* сначала берём поле из пула, затем номер: так у каждого незаписанного
+           номера есть своё поле, и писатель всегда дождётся очередного номера */
+        PipeItem* it = (PipeItem*)pipe_pop(&pp->free_items);
+        if (!it) { pipe_backoff(&wait); continue; }
+        wait = 0;
+
+        uint64_t k = (uint64_t)(unsigned long)mt_atomic_add(&pp->next_index, 1);
+        uint64_t seed = rng_derive(p->seed, k);
+        uint64_t t0 = mt_now_ns();
+        if (p->repair_rounds > 0) pipe_repair(w, seed, it);
+        else if (p->mines >= 0) pargen_run_exact(w->gen, p->mines, seed, p->max_attempts, it->field, &it->res);
+        else pargen_run(w->gen, p->percent, seed, p->max_attempts, it->field, &it->res);
+        it->ns = mt_now_ns() - t0;
+        it->index = k;
+
+        while (!pipe_push(&pp->ready, it)) {
+            if (mt_atomic_load(&pp->stop)) return;
+            pipe_backoff(&wait);
+        }
+        wait = 0;
+    }
+}
+
+bool pipeline_run(const PipeParams* p, PipeSink sink, void* user, PipeStats* stats) {
+    PipeStats st = { 0, 0, 0, false };
+    if (stats) *stats = st;
+    if (!p || !sink || p->count <= 0) return false;
+
+    int threads = p->threads > 0 ? p->threads : mt_cpu_count();
+    long qsize = p->queue_size > 0 ? p->queue_size : PIPE_QUEUE_DEFAULT;
+    long pool = qsize + threads;   /* поля в очереди плюс по одному у каждого рабочего */
+
+    Pipe pp;
+    memset(&pp, 0, sizeof pp);
+    pp.p = p;
+    PipeItem* items = (PipeItem*)calloc((size_t)pool, sizeof(PipeItem));
+    PipeItem** pending = (PipeItem**)calloc((size_t)pool, sizeof(PipeItem*));
+    PipeWorker* workers = (PipeWorker*)calloc((size_t)threads, sizeof(PipeWorker));
+    bool ok = items && pending && workers
+        && pipe_queue_init(&pp.ready, qsize) && pipe_queue_init(&pp.free_items, pool);
+
+    for (long i = 0; ok && i < pool; ++i) {
+        items[i].field = field_create(p->rows, p->cols);
+        ok = items[i].field != NULL && pipe_push(&pp.free_items, &items[i]);
+    }
+    for (int t = 0; ok && t < threads; ++t) {
+        workers[t].owner = &pp;
+        workers[t].gen = pargen_create(p->rows, p->cols, 1);
+        if (p->repair_rounds > 0) workers[t].ctx = solver_ctx_create(p->rows, p->cols);
+        ok = workers[t].gen != NULL && (p->repair_rounds <= 0 || workers[t].ctx != NULL);
+        if (ok) {
+            pargen_set_strength(workers[t].gen, p->strength);
+            solver_ctx_set_strength(workers[t].ctx, p->strength);
+            if (p->stats) solver_ctx_set_stats(workers[t].ctx, &workers[t].stats);
+            if (p->start_r >= 0) pargen_set_start(workers[t].gen, p->start_r, p->start_c);
+            if (p->stats) pargen_set_stats(workers[t].gen, &workers[t].stats);
+        }
+    }
+
+    int started = 0;
+    for (; ok && started < threads; ++started)
+        if (!mt_thread_start(&workers[started].thread, pipe_worker, &workers[started])) break;
+    ok = ok && started > 0;
+
+    /* писатель: незаписанные номера лежат в окне [next, next + pool), поэтому
+       слот pending[index % pool] у каждого из них свой */
+    uint64_t next = 0;
+    long fails_in_row = 0;
+    bool done = !ok;
+    int wait = 0;
+    while (!done) {
+        PipeItem* it = (PipeItem*)pipe_pop(&pp.ready);
+        if (!it) { pipe_backoff(&wait); continue; }
+        wait = 0;
+        pending[it->index % (uint64_t)pool] = it;
+
+        while (!done && (it = pending[next % (uint64_t)pool]) != NULL && it->index == next) {
+            pending[next % (uint64_t)pool] = NULL;
+            ++next;
+            st.attempts += it->res.attempts_made;
+            if (it->res.solvable) { ++st.made; fails_in_row = 0; }
+            else { ++st.failed; ++fails_in_row; }
+
+            if (!sink(user, it->index, it->field, &it->res, it->ns)) { ok = false; done = true; }
+            else if (st.made >= p->count) done = true;
+            else if (p->max_fails > 0 && fails_in_row >= p->max_fails) {
+                st.too_many_fails = true;
+                ok = false;
+                done = true;
+            }
+            pipe_push(&pp.free_items, it); /* ёмкость пула не меньше числа полей */
+        }
+    }
+
+    mt_atomic_store(&pp.stop, 1);
+    for (int t = 0; t < started; ++t) mt_thread_join(workers[t].thread);
+
+    if (workers)
+        for (int t = 0; t < threads; ++t) {
+            if (p->stats) stats_merge(p->stats, &workers[t].stats);
+            pargen_free(workers[t].gen);
+            solver_ctx_free(workers[t].ctx);
+        }
+    if (items)
+        for (long i = 0; i < pool; ++i) field_free(items[i].field);
+    free(workers);
+    free(pending);
+    free(items);
+    free(pp.ready.cells);
+    free(pp.free_items.cells);
+
+    if (stats) *stats = st;
+    return ok && st.made >= p->count;
+}
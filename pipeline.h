@@ -0,0 +1,59 @@
+#ifndef MINES_PIPELINE_H
+#define MINES_PIPELINE_H
+
+#include "generator.h"
+
+/* -------------------------------------------------------------------
+   Конвейер "генерация -> запись" для больших пакетов полей.
+   Рабочие потоки строят поля целиком (каждый своим однопоточным ParGen) и
+   кладут готовые поля в ограниченную lock-free очередь (MPMC, схема Вьюкова).
+   Вызывающий поток — писатель: забирает поля, восстанавливает порядок номеров
+   и передаёт их приёмнику, пока рабочие уже решают следующие поля.
+   Поля не создаются заново: они берутся из пула (вторая такая же очередь)
+   и возвращаются в него после записи. Если очередь полна или пул пуст,
+   рабочие ждут (обратное давление), так что память ограничена. Ожидание
+   (и писателя, пока поля генерируются) — короткое вращение, затем сон с
+   нарастающим до 1 мс интервалом, так что простаивающий поток не занимает ядро.
+   Поле номер k строится из зерна rng_derive(seed, k) — результат тот же, что у
+   последовательного pargen_run (или generate_repair с Rng из этого зерна),
+   и не зависит от числа потоков.
+   ------------------------------------------------------------------- */
+
+/* Параметры конвейера */
+typedef struct {
+    int rows, cols;
+    int percent;            /* вероятность мины, если mines < 0 */
+    int mines;              /* >= 0: точное число мин */
+    int start_r, start_c;   /* известный первый клик (-1 — перебирать старты) */
+    SolverStrength strength;
+    uint64_t seed;
+    int max_attempts;       /* попыток на одно поле */
+    int repair_rounds;      /* > 0: поле строится generate_repair из старта start_r,start_c
+                               (обязателен) с таким числом раундов вместо перебора попыток */
+    long count;             /* сколько решаемых полей передать приёмнику */
+    int max_fails;          /* остановиться после стольких нерешаемых полей подряд (0 — не останавливаться) */
+    int threads;            /* рабочих потоков (0 = по числу ядер) */
+    int queue_size;         /* ёмкость очереди готовых полей (0 — по умолчанию) */
+    GenStats* stats;        /* сюда добавляется статистика всех потоков (NULL — не собирать) */
+} PipeParams;
+
+/* Итог работы конвейера */
+typedef struct {
+    long made;              /* передано решаемых полей */
+    long failed;            /* нерешаемых (пропущенных) полей */
+    long attempts;          /* попыток генерации по всем полям */
+    bool too_many_fails;    /* остановлен из-за max_fails подряд */
+} PipeStats;
+
+/* Приёмник готовых полей: вызывается в потоке писателя строго по порядку index,
+   в том числе для нерешаемых полей (res->solvable == false) — их не нужно записывать.
+   gen_ns — время генерации этого поля. Возврат false прерывает конвейер. */
+typedef bool (*PipeSink)(void* user, uint64_t index, const Field* f, const GenResult* res, uint64_t gen_ns);
+
+/* pipeline_run
+   - Генерирует поля, пока приёмник не получит count решаемых.
+   - Возвращает true, если все count полей переданы приёмнику.
+*/
+bool pipeline_run(const PipeParams* p, PipeSink sink, void* user, PipeStats* stats);
+
+#endif /* MINES_PIPELINE_H */
@@ -0,0 +1,110 @@
+#include "render.h"
+
+/* Шкала плотности мин для обзора: от пустого блока к блоку из одних мин */
+static const char RENDER_RAMP[] = " .:-=+*#%@";
+#define RENDER_RAMP_LEN ((int)sizeof(RENDER_RAMP) - 1)
+
+size_t render_frame_size(int h, int w) {
+    if (h <= 0 || w <= 0) return 0;
+    /* строка: '|' или '+', по 4 символа на клетку, '\n'; строк 2h+1 */
+    return (size_t)(2 * (size_t)h + 1) * (4 * (size_t)w + 2);
+}
+
+/* Горизонтальная линия "+---+---+...\n" */
+static char* render_rule(char* p, int w) {
+    *p++ = '+';
+    for (int c = 0; c < w; ++c) {
+        memcpy(p, "---+", 4);
+        p += 4;
+    }
+    *p++ = '\n';
+    return p;
+}
+
+size_t render_grid(const Field* f, int r0, int c0, int h, int w, bool show_mines, char* buf) {
+    if (!f || !buf || h <= 0 || w <= 0) return 0;
+    (void)show_mines; /* мины всегда показываются '*', как и раньше в print_field_ascii */
+    char* p = render_rule(buf, w);
+
+    for (int r = r0; r < r0 + h; ++r) {
+        const unsigned char* mine = f->is_mine + IDX(f, r, c0);
+        const unsigned char* cnt = f->count + IDX(f, r, c0);
+        *p++ = '|';
+        for (int c = 0; c < w; ++c) {
+            p[0] = ' ';
+            p[1] = mine[c] ? '*' : (cnt[c] == 0 ? '.' : (char)('0' + cnt[c]));
+            p[2] = ' ';
+            p[3] = '|';
+            p += 4;
+        }
+        *p++ = '\n';
+        p = render_rule(p, w);
+    }
+    return (size_t)(p - buf);
+}
+
+bool render_viewport(const Field* f, int r0, int c0, int h, int w, bool show_mines, FILE* out) {
+    if (!f || !out) return false;
+    if (r0 < 0) r0 = 0;
+    if (c0 < 0) c0 = 0;
+    if (r0 >= f->rows || c0 >= f->cols) return true;
+    if (h > f->rows - r0) h = f->rows - r0;
+    if (w > f->cols - c0) w = f->cols - c0;
+    if (h <= 0 || w <= 0) return true;
+
+    if (h < f->rows || w < f->cols)
+        fprintf(out, "Окно: строки %d..%d, столбцы %d..%d из %dx%d\n",
+            r0, r0 + h - 1, c0, c0 + w - 1, f->rows, f->cols);
+
+    size_t size = render_frame_size(h, w);
+    char* buf = (char*)malloc(size);
+    if (!buf) return false;
+    size_t len = render_grid(f, r0, c0, h, w, show_mines, buf);
+    bool ok = fwrite(buf, 1, len, out) == len;
+    free(buf);
+    return ok;
+}
+
+bool render_overview(const Field* f, int max_rows, int max_cols, FILE* out) {
+    if (!f || !out || max_rows <= 0 || max_cols <= 0) return false;
+    int R = f->rows, C = f->cols;
+    int bh = (R + max_rows - 1) / max_rows;   /* клеток в блоке по вертикали */
+    int bw = (C + max_cols - 1) / max_cols;   /* и по горизонтали */
+    int oh = (R + bh - 1) / bh, ow = (C + bw - 1) / bw;
+
+    size_t line = (size_t)ow + 3;   /* '|' + символы + '|' + '\n' */
+    size_t size = (size_t)(oh + 2) * line;
+    char* buf = (char*)malloc(size);
+    long* sum = (long*)malloc((size_t)ow * sizeof(long));
+    if (!buf || !sum) { free(buf); free(sum); return false; }
+
+    fprintf(out, "Обзор %dx%d: символ = блок %dx%d клеток, шкала доли мин \"%s\"\n",
+        R, C, bh, bw, RENDER_RAMP);
+
+    char* p = buf;
+    *p++ = '+'; memset(p, '-', (size_t)ow); p += ow; *p++ = '+'; *p++ = '\n';
+    for (int orow = 0; orow < oh; ++orow) {
+        int ra = orow * bh, rb = ra + bh < R ? ra + bh : R;
+        memset(sum, 0, (size_t)ow * sizeof(long));
+        for (int r = ra; r < rb; ++r) {
+            const unsigned char* mine = f->is_mine + IDX(f, r, 0);
+            for (int c = 0; c < C; ++c) sum[c / bw] += mine[c];
+        }
+        *p++ = '|';
+        for (int oc = 0; oc < ow; ++oc) {
+            int ca = oc * bw, cb = ca + bw < C ? ca + bw : C;
+            long cells = (long)(rb - ra) * (cb - ca);
+            int lvl = (int)((sum[oc] * (RENDER_RAMP_LEN - 1) + cells - 1) / cells); /* любая мина видна */
+            *p++ = RENDER_RAMP[lvl];
+        }
+        *p++ = '|';
+        *p++ = '\n';
+    }
+    *p++ = '+'; memset(p, '-', (size_t)ow); p += ow; *p++ = '+'; *p++ = '\n';
+
+    size_t len = (size_t)(p - buf);
+    bool ok = fwrite(buf, 1, len, out) == len;
+    free(sum);
+    free(buf);
+    return ok;
+}
@@ -0,0 +1,40 @@
+#ifndef MINES_RENDER_H
+#define MINES_RENDER_H
+
+#include "field.h"
+
+/* -------------------------------------------------------------------
+   Вывод поля в консоль. Весь кадр собирается в одном заранее выделенном
+   буфере точного размера и выводится одним fwrite, вместо нескольких
+   printf на клетку. Для больших полей есть окно (часть поля) и
+   уменьшенный обзор, чтобы не выводить гигабайты текста.
+   ------------------------------------------------------------------- */
+
+/* render_frame_size
+   - Размер в байтах таблицы h x w клеток в формате print_field_ascii.
+*/
+size_t render_frame_size(int h, int w);
+
+/* render_grid
+   - Рисует в buf таблицу клеток [r0, r0+h) x [c0, c0+w) (окно должно лежать в поле).
+   - buf должен вмещать render_frame_size(h, w) байт. Возвращает число записанных байт.
+*/
+size_t render_grid(const Field* f, int r0, int c0, int h, int w, bool show_mines, char* buf);
+
+/* render_viewport
+   - Выводит в out окно поля: строки r0..r0+h-1, столбцы c0..c0+w-1.
+   - Окно обрезается по границам поля. Если окно меньше поля, перед таблицей
+     печатается строка с его координатами.
+   - Возвращает false при ошибке выделения памяти или записи.
+*/
+bool render_viewport(const Field* f, int r0, int c0, int h, int w, bool show_mines, FILE* out);
+
+/* render_overview
+   - Выводит уменьшенный обзор поля не больше max_rows x max_cols символов:
+     каждый символ — блок клеток, яркость символа — доля мин в блоке
+     (' ' — мин нет, '@' — только мины).
+   - Поле просматривается один раз построчно, память — на одну строку обзора.
+*/
+bool render_overview(const Field* f, int max_rows, int max_cols, FILE* out);
+
+#endif /* MINES_RENDER_H */
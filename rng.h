@@ -0,0 +1,125 @@
+#ifndef MINES_RNG_H
+#define MINES_RNG_H
+
+#include <stdint.h>
+
+/* -------------------------------------------------------------------
+   Rng: собственный генератор псевдослучайных чисел.
+   В отличие от глобального rand(), у каждого генератора своё состояние,
+   поэтому он потокобезопасен и воспроизводим по зерну (seed).
+   Алгоритм выбирается при инициализации (RngKind):
+     RNG_XOSHIRO256SS — xoshiro256** (по умолчанию, быстрый и качественный);
+     RNG_PCG32        — PCG-XSH-RR 32 (маленькое состояние, два вызова на 64 бита);
+     RNG_SPLITMIX64   — splitmix64 (самый простой).
+   ------------------------------------------------------------------- */
+typedef enum {
+    RNG_XOSHIRO256SS = 0,
+    RNG_PCG32 = 1,
+    RNG_SPLITMIX64 = 2
+} RngKind;
+
+typedef struct {
+    RngKind kind;
+    uint64_t s[4];
+} Rng;
+
+/* splitmix64: перемешивание 64-битного значения (используется и для вывода зёрен) */
+static inline uint64_t rng_mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rng_rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint32_t rng_rotr32(uint32_t x, unsigned k) {
+    return (x >> k) | (x << ((32 - k) & 31));
+}
+
+/* rng_seed_kind
+   - Инициализирует генератор выбранного типа из 64-битного зерна.
+   - Состояние xoshiro/PCG заполняется через splitmix64, поэтому любое зерно (и 0) допустимо.
+*/
+static inline void rng_seed_kind(Rng* g, RngKind kind, uint64_t seed) {
+    uint64_t z = seed;
+    g->kind = kind;
+    for (int i = 0; i < 4; ++i) {
+        z += 0x9E3779B97F4A7C15ULL;
+        g->s[i] = rng_mix64(z);
+    }
+    if (kind == RNG_SPLITMIX64) g->s[0] = seed;
+    if (kind == RNG_PCG32) g->s[1] |= 1; /* приращение PCG должно быть нечётным */
+}
+
+static inline void rng_seed(Rng* g, uint64_t seed) {
+    rng_seed_kind(g, RNG_XOSHIRO256SS, seed);
+}
+
+static inline uint32_t rng_pcg32(Rng* g) {
+    uint64_t old = g->s[0];
+    g->s[0] = old * 6364136223846793005ULL + g->s[1];
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    return rng_rotr32(xorshifted, (unsigned)(old >> 59));
+}
+
+/* rng_next
+   - Следующее 64-битное случайное число.
+*/
+static inline uint64_t rng_next(Rng* g) {
+    switch (g->kind) {
+    case RNG_PCG32: {
+        uint64_t hi = rng_pcg32(g);
+        return (hi << 32) | rng_pcg32(g);
+    }
+    case RNG_SPLITMIX64:
+        g->s[0] += 0x9E3779B97F4A7C15ULL;
+        return rng_mix64(g->s[0]);
+    default: {
+        uint64_t* s = g->s;
+        uint64_t result = rng_rotl64(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rng_rotl64(s[3], 45);
+        return result;
+    }
+    }
+}
+
+/* rng_below
+   - Равномерное целое в [0, n) без смещения остатка от деления (метод Лемира).
+*/
+static inline uint32_t rng_below(Rng* g, uint32_t n) {
+    uint64_t m = (rng_next(g) >> 32) * (uint64_t)n;
+    uint32_t low = (uint32_t)m;
+    if (low < n) {
+        uint32_t t = (uint32_t)(0u - n) % n;
+        while (low < t) {
+            m = (rng_next(g) >> 32) * (uint64_t)n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+/* rng_percent_threshold
+   - Порог для 32-битного случайного числа: x < порог с вероятностью percent/100
+     (без остатка от деления; percent >= 100 обрабатывается вызывающим отдельно).
+*/
+static inline uint32_t rng_percent_threshold(int percent) {
+    return (uint32_t)(((uint64_t)percent << 32) / 100);
+}
+
+/* rng_derive
+   - Независимое зерно для потока (попытки) номер index, полученное из общего seed.
+*/
+static inline uint64_t rng_derive(uint64_t seed, uint64_t index) {
+    return rng_mix64(seed ^ rng_mix64(index + 0x9E3779B97F4A7C15ULL));
+}
+
+#endif /* MINES_RNG_H */
@@ -0,0 +1,527 @@
+#include "service.h"
+#include "batch.h"
+#include "fielddesc.h"
+#include "calib.h"
+#include "mt.h"
+#include <stdio.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/* Наибольшая сторона поля, которое держится в пуле */
+#define SVC_MAX_SIDE 1024
+
+/* Подряд неудачных полей, после которых конфигурация больше не пополняется */
+#define SVC_MAX_FAILS 10
+
+/* Конфигурация и её пул: кольцо дескрипторов готовых полей */
+typedef struct {
+    int rows, cols, percent;
+    FieldDesc* ring;
+    int head, size;         /* первое готовое поле и их число */
+    int busy;               /* сколько полей сейчас генерируется для пула */
+    long next;              /* номер следующего поля: зерно rng_derive(seed, next) */
+    uint64_t seed;
+    long hits, misses, made, failed;
+    int fails_in_row;
+    bool dead;              /* параметры безнадёжны: пул не пополняется */
+    int attempts;           /* бюджет попыток на поле (по калибровке) */
+    int suggest;            /* плотность с решаемыми полями для отказа (-1 — неизвестна) */
+} SvcKey;
+
+typedef struct Service Service;
+
+/* Фоновый поток со своим генератором (пересоздаётся при смене размера) */
+typedef struct {
+    Service* owner;
+    mt_thread thread;
+    ParGen* gen;
+    Field* field;
+} SvcWorker;
+
+struct Service {
+    int pool;
+    int attempts;
+    int deadline_ms;        /* срок генерации при промахе (0 — без срока) */
+    SolverStrength strength;
+    uint64_t seed;
+    int max_keys;
+    SvcKey* keys;
+    int n_keys;
+
+    mt_mutex lock;          /* защищает ключи, пулы и счётчики */
+    mt_cond wake;           /* для фоновых потоков: появилась работа или выход */
+    bool quit;
+    volatile long cancel;   /* поднимается вместе с quit: прерывает идущие генерации */
+    int threads;
+    SvcWorker* workers;
+
+    long hits, misses, refilled;
+    uint64_t hit_ns;        /* суммарное время обслуживания попаданий */
+    uint64_t t_start;
+
+    CalibTable* calib;      /* калибровка (calib.h), под lock; NULL — без неё */
+    const char* calib_path;
+
+#ifndef _WIN32
+    int listen_fd;
+    int* clients;           /* открытые сеансы: закрываются при остановке */
+    int n_clients, cap_clients;
+#endif
+};
+
+/* ---------- Пулы ---------- */
+
+static SvcKey* svc_find(Service* s, int rows, int cols, int percent) {
+    for (int i = 0; i < s->n_keys; ++i) {
+        SvcKey* k = &s->keys[i];
+        if (k->rows == rows && k->cols == cols && k->percent == percent) return k;
+    }
+    return NULL;
+}
+
+/* Находит или заводит конфигурацию; NULL, если таблица заполнена */
+static SvcKey* svc_key(Service* s, int rows, int cols, int percent) {
+    SvcKey* k = svc_find(s, rows, cols, percent);
+    if (k || s->n_keys == s->max_keys) return k;
+    FieldDesc* ring = (FieldDesc*)malloc((size_t)s->pool * sizeof(FieldDesc));
+    if (!ring) return NULL;
+    k = &s->keys[s->n_keys++];
+    memset(k, 0, sizeof *k);
+    k->rows = rows;
+    k->cols = cols;
+    k->percent = percent;
+    k->ring = ring;
+    /* у каждой конфигурации свой поток зёрен */
+    k->seed = rng_derive(s->seed, ((uint64_t)rows << 40) ^ ((uint64_t)cols << 16) ^ (uint64_t)percent);
+    /* бюджет попыток по калибровке; безнадёжная конфигурация не пополняется вовсе */
+    CalibPlan plan;
+    calib_plan(s->calib, rows, cols, percent, s->strength, false, s->attempts, &plan);
+    k->attempts = plan.attempts;
+    k->suggest = plan.suggest_percent;
+    k->dead = plan.verdict == CALIB_INFEASIBLE;
+    return k;
+}
+
+/* Конфигурация, пул которой заполнен меньше всех (с учётом генерируемых полей) */
+static SvcKey* svc_pick(Service* s) {
+    SvcKey* best = NULL;
+    for (int i = 0; i < s->n_keys; ++i) {
+        SvcKey* k = &s->keys[i];
+        if (k->dead || k->size + k->busy >= s->pool) continue;
+        if (!best || k->size + k->busy < best->size + best->busy) best = k;
+    }
+    return best;
+}
+
+/* Генерация одного поля конфигурации; вызывается без блокировки.
+   В limits всегда есть флаг s->cancel, у промаха — ещё и срок. */
+static GenStatus svc_generate(Service* s, ParGen* gen, Field* field, int rows, int cols, int percent,
+    int attempts, uint64_t seed, const GenLimits* limits, FieldDesc* d, int* made) {
+    GenResult res;
+    GenStatus st = pargen_run_limited(gen, percent, -1, seed, attempts, limits, field, &res);
+    fdesc_init(d, rows, cols, percent, -1, -1, -1, s->strength, 0);
+    fdesc_set_result(d, &res);
+    *made = (int)calib_trials(&res);
+    return st;
+}
+
+/* Итог генерации (made попыток) для пула и калибровки; под блокировкой.
+   Прерванная по сроку генерация не считается неудачей конфигурации. */
+static void svc_account(Service* s, SvcKey* k, GenStatus st, int made) {
+    bool ok = st == GEN_SOLVED;
+    calib_record(s->calib, k->rows, k->cols, k->percent, s->strength, false, made, ok ? 1 : 0);
+    if (ok) {
+        ++k->made;
+        k->fails_in_row = 0;
+    }
+    else if (st == GEN_EXHAUSTED) {
+        ++k->failed;
+        if (++k->fails_in_row >= SVC_MAX_FAILS) k->dead = true;
+    }
+}
+
+static void svc_worker(void* arg) {
+    SvcWorker* w = (SvcWorker*)arg;
+    Service* s = w->owner;
+
+    mt_mutex_lock(&s->lock);
+    for (;;) {
+        SvcKey* k;
+        while (!s->quit && !(k = svc_pick(s))) mt_cond_wait(&s->wake, &s->lock);
+        if (s->quit) break;
+
+        int rows = k->rows, cols = k->cols, percent = k->percent, attempts = k->attempts;
+        uint64_t seed = rng_derive(k->seed, (uint64_t)k->next++);
+        ++k->busy;
+        mt_mutex_unlock(&s->lock);
+
+        /* генератор и поле переиспользуются, пока не сменится размер */
+        if (!w->gen || w->field->rows != rows || w->field->cols != cols) {
+            pargen_free(w->gen);
+            field_free(w->field);
+            w->gen = pargen_create(rows, cols, 1);
+            w->field = field_create(rows, cols);
+            if (w->gen) pargen_set_strength(w->gen, s->strength);
+        }
+        FieldDesc d;
+        int made = 0;
+        GenLimits limits;
+        memset(&limits, 0, sizeof limits);
+        limits.cancel = &s->cancel; /* остановка сервиса не ждёт, пока пополнение доиграет */
+        GenStatus st = w->gen && w->field
+            ? svc_generate(s, w->gen, w->field, rows, cols, percent, attempts, seed, &limits, &d, &made)
+            : GEN_EXHAUSTED;
+        bool ok = st == GEN_SOLVED;
+
+        mt_mutex_lock(&s->lock);
+        /* ключи не удаляются и массив не перевыделяется, так что k всё ещё верен */
+        --k->busy;
+        svc_account(s, k, st, made);
+        if (ok && k->size < s->pool) {
+            k->ring[(k->head + k->size) % s->pool] = d;
+            ++k->size;
+            ++s->refilled;
+        }
+    }
+    mt_mutex_unlock(&s->lock);
+    pargen_free(w->gen);
+    field_free(w->field);
+}
+
+/* ---------- Запросы ---------- */
+
+/* Выдаёт дескриптор решаемого поля: из пула или, при промахе, генерирует сразу */
+static bool svc_take(Service* s, int rows, int cols, int percent, FieldDesc* d, bool* hit, char* err, size_t err_size) {
+    mt_mutex_lock(&s->lock);
+    SvcKey* k = svc_key(s, rows, cols, percent);
+    if (!k) { mt_mutex_unlock(&s->lock); snprintf(err, err_size, "too many configurations"); return false; }
+    *hit = k->size > 0;
+    if (*hit) {
+        *d = k->ring[k->head];
+        k->head = (k->head + 1) % s->pool;
+        --k->size;
+        ++k->hits;
+        ++s->hits;
+    }
+    else {
+        ++k->misses;
+        ++s->misses;
+    }
+    bool dead = k->dead;
+    int attempts = k->attempts, suggest = k->suggest;
+    uint64_t seed = rng_derive(k->seed, (uint64_t)k->next);
+    if (!*hit && !dead) ++k->next;
+    mt_cond_broadcast(&s->wake); /* пул убыл (или новый ключ): фоновым потокам есть работа */
+    mt_mutex_unlock(&s->lock);
+    if (*hit) return true;
+    if (dead) {
+        if (suggest >= 0) snprintf(err, err_size, "density too high: no solvable boards (try %d%%)", suggest);
+        else snprintf(err, err_size, "density too high: no solvable boards");
+        return false;
+    }
+
+    /* промах: генерация в потоке запроса всеми ядрами */
+    ParGen* gen = pargen_create(rows, cols, 0);
+    Field* field = field_create(rows, cols);
+    GenStatus st = GEN_EXHAUSTED;
+    int made = 0;
+    if (gen && field) {
+        GenLimits limits;
+        memset(&limits, 0, sizeof limits);
+        limits.cancel = &s->cancel;
+        if (s->deadline_ms > 0) limits.deadline_ns = mt_now_ns() + (uint64_t)s->deadline_ms * 1000000u;
+        pargen_set_strength(gen, s->strength);
+        st = svc_generate(s, gen, field, rows, cols, percent, attempts, seed, &limits, d, &made);
+    }
+    if (!gen || !field) snprintf(err, err_size, "out of memory");
+    else if (st == GEN_TIMEOUT || st == GEN_NO_TIME)
+        snprintf(err, err_size, "timeout: no solvable board within %d ms (%d attempts)", s->deadline_ms, made);
+    else if (st == GEN_CANCELLED) snprintf(err, err_size, "cancelled: service is stopping");
+    else if (st != GEN_SOLVED) snprintf(err, err_size, "no solvable board within %d attempts", attempts);
+    pargen_free(gen);
+    field_free(field);
+    mt_mutex_lock(&s->lock);
+    svc_account(s, k, st, made);
+    mt_mutex_unlock(&s->lock);
+    return st == GEN_SOLVED;
+}
+
+static void svc_stats(Service* s, FILE* out) {
+    mt_mutex_lock(&s->lock);
+    double up = (mt_now_ns() - s->t_start) / 1e9;
+    fprintf(out, "OK uptime_s=%.1f keys=%d hits=%ld misses=%ld refilled=%ld refill_per_s=%.1f hit_us=%.2f threads=%d\n",
+        up, s->n_keys, s->hits, s->misses, s->refilled, up > 0 ? s->refilled / up : 0.0,
+        s->hits ? s->hit_ns / 1e3 / s->hits : 0.0, s->threads);
+    for (int i = 0; i < s->n_keys; ++i) {
+        const SvcKey* k = &s->keys[i];
+        fprintf(out, "key %d %d %d pool=%d/%d hits=%ld misses=%ld made=%ld failed=%ld%s\n",
+            k->rows, k->cols, k->percent, k->size, s->pool, k->hits, k->misses, k->made, k->failed,
+            k->dead ? " dead" : "");
+    }
+    mt_mutex_unlock(&s->lock);
+    fprintf(out, "END\n");
+}
+
+/* Один запрос; false — закончить сеанс (*stop — остановить сервис) */
+static bool svc_request(Service* s, char* line, FILE* out, bool* stop) {
+    char cmd[16];
+    int rows, cols, percent, n = sscanf(line, "%15s %d %d %d", cmd, &rows, &cols, &percent);
+    if (n < 1) return true; /* пустая строка */
+
+    if (strcmp(cmd, "QUIT") == 0) return false;
+    if (strcmp(cmd, "SHUTDOWN") == 0) { fprintf(out, "OK\n"); *stop = true; return false; }
+    if (strcmp(cmd, "STATS") == 0) { svc_stats(s, out); return true; }
+
+    bool get = strcmp(cmd, "GET") == 0, desc = strcmp(cmd, "DESC") == 0, warm = strcmp(cmd, "WARM") == 0;
+    if (!get && !desc && !warm) { fprintf(out, "ERR unknown command\n"); return true; }
+    if (n != 4 || rows <= 0 || cols <= 0 || rows > SVC_MAX_SIDE || cols > SVC_MAX_SIDE
+        || percent < 0 || percent > 100) {
+        fprintf(out, "ERR usage: %s ROWS COLS PERCENT (sides up to %d)\n", cmd, SVC_MAX_SIDE);
+        return true;
+    }
+    if (warm) {
+        mt_mutex_lock(&s->lock);
+        bool ok = svc_key(s, rows, cols, percent) != NULL;
+        mt_cond_broadcast(&s->wake);
+        mt_mutex_unlock(&s->lock);
+        fprintf(out, ok ? "OK\n" : "ERR too many configurations\n");
+        return true;
+    }
+
+    uint64_t t0 = mt_now_ns();
+    FieldDesc d;
+    bool hit;
+    char err[96];
+    if (!svc_take(s, rows, cols, percent, &d, &hit, err, sizeof err)) { fprintf(out, "ERR %s\n", err); return true; }
+
+    if (desc) {
+        const unsigned char* p = (const unsigned char*)&d;
+        fprintf(out, "OK %s ", hit ? "hit" : "miss");
+        for (size_t i = 0; i < sizeof d; ++i) fprintf(out, "%02x", p[i]);
+        fprintf(out, "\n");
+    }
+    else {
+        Field* f = fdesc_build(&d);
+        if (!f) { fprintf(out, "ERR out of memory\n"); return true; }
+        fprintf(out, "OK %s %016llx %d %d\n", hit ? "hit" : "miss",
+            (unsigned long long)d.seed, d.start_r, d.start_c);
+        write_field(f, out);
+        field_free(f);
+    }
+    if (hit) {
+        mt_mutex_lock(&s->lock);
+        s->hit_ns += mt_now_ns() - t0;
+        mt_mutex_unlock(&s->lock);
+    }
+    return true;
+}
+
+/* Сеанс: запросы по строкам до QUIT, SHUTDOWN или конца ввода */
+static bool svc_session(Service* s, FILE* in, FILE* out) {
+    char line[256];
+    bool stop = false;
+    while (fgets(line, sizeof line, in)) {
+        bool more = svc_request(s, line, out, &stop);
+        fflush(out);
+        if (!more) break;
+    }
+    return stop;
+}
+
+/* ---------- Unix-сокет ---------- */
+
+#ifndef _WIN32
+typedef struct {
+    Service* s;
+    int fd;
+    mt_thread thread;
+} SvcClient;
+
+static void svc_client_remove(Service* s, int fd) {
+    mt_mutex_lock(&s->lock);
+    for (int i = 0; i < s->n_clients; ++i)
+        if (s->clients[i] == fd) { s->clients[i] = s->clients[--s->n_clients]; break; }
+    mt_mutex_unlock(&s->lock);
+}
+
+static void svc_client(void* arg) {
+    SvcClient* c = (SvcClient*)arg;
+    Service* s = c->s;
+    int wfd = dup(c->fd);
+    FILE* in = fdopen(c->fd, "r");
+    FILE* out = wfd >= 0 ? fdopen(wfd, "w") : NULL;
+    bool stop = in && out && svc_session(s, in, out);
+    svc_client_remove(s, c->fd);
+    if (out) fclose(out); else if (wfd >= 0) close(wfd);
+    if (in) fclose(in); else close(c->fd);
+
+    if (stop) {
+        /* будим accept и остальные сеансы: их чтение вернёт конец ввода */
+        mt_mutex_lock(&s->lock);
+        s->quit = true;
+        mt_atomic_store(&s->cancel, 1);
+        for (int i = 0; i < s->n_clients; ++i)
+            shutdown(s->clients[i], SHUT_RDWR);
+        mt_mutex_unlock(&s->lock);
+        shutdown(s->listen_fd, SHUT_RDWR);
+    }
+}
+
+static int svc_listen(Service* s, const char* path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof addr.sun_path) { fprintf(stderr, "Слишком длинный путь сокета\n"); return 1; }
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    s->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (s->listen_fd < 0 || bind(s->listen_fd, (struct sockaddr*)&addr, sizeof addr) != 0
+        || listen(s->listen_fd, 16) != 0) {
+        fprintf(stderr, "Не удалось открыть сокет %s\n", path);
+        if (s->listen_fd >= 0) close(s->listen_fd);
+        return 1;
+    }
+    fprintf(stderr, "Сервис слушает %s\n", path);
+
+    SvcClient** all = NULL;
+    int n_all = 0;
+    for (;;) {
+        int fd = accept(s->listen_fd, NULL, NULL);
+        mt_mutex_lock(&s->lock);
+        bool quit = s->quit;
+        if (fd >= 0 && !quit && s->n_clients == s->cap_clients) {
+            int cap = s->cap_clients ? s->cap_clients * 2 : 16;
+            int* p = (int*)realloc(s->clients, (size_t)cap * sizeof(int));
+            if (p) { s->clients = p; s->cap_clients = cap; }
+        }
+        bool room = s->n_clients < s->cap_clients;
+        if (fd >= 0 && !quit && room) s->clients[s->n_clients++] = fd;
+        mt_mutex_unlock(&s->lock);
+        if (quit) { if (fd >= 0) close(fd); break; }
+        if (fd < 0) continue;
+
+        SvcClient* c = (SvcClient*)malloc(sizeof(SvcClient));
+        SvcClient** grown = (SvcClient**)realloc(all, (size_t)(n_all + 1) * sizeof(SvcClient*));
+        if (grown) all = grown;
+        if (!room || !c || !grown) { free(c); svc_client_remove(s, fd); close(fd); continue; }
+        c->s = s;
+        c->fd = fd;
+        if (!mt_thread_start(&c->thread, svc_client, c)) { free(c); svc_client_remove(s, fd); close(fd); continue; }
+        all[n_all++] = c;
+    }
+    for (int i = 0; i < n_all; ++i) {
+        mt_thread_join(all[i]->thread);
+        free(all[i]);
+    }
+    free(all);
+    close(s->listen_fd);
+    unlink(path);
+    return 0;
+}
+#endif
+
+/* ---------- Запуск ---------- */
+
+static void svc_usage(const char* prog) {
+    fprintf(stderr,
+        "Использование: %s --serve [--socket PATH] [--pool N] [--threads T] [--attempts A]\n"
+        "       [--strength basic|subset] [--seed S] [--max-keys K] [--calib PATH]\n"
+        "       [--deadline-ms D]\n", prog);
+}
+
+int run_service(int argc, char** argv) {
+    Service s;
+    memset(&s, 0, sizeof s);
+    s.pool = 32;
+    s.attempts = 1000;
+    s.strength = SOLVER_SUBSET;
+    s.seed = (uint64_t)time(NULL);
+    s.max_keys = 64;
+    s.threads = mt_cpu_count() - 1;
+    const char* socket_path = NULL;
+
+    for (int i = 2; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[++i] : NULL;
+        if (!v) { svc_usage(argv[0]); return 2; }
+        long x = 0;
+        bool ok = true;
+        if (strcmp(a, "--socket") == 0) socket_path = v;
+        else if (strcmp(a, "--pool") == 0) { ok = batch_long(v, 1, 1L << 20, &x); s.pool = (int)x; }
+        else if (strcmp(a, "--threads") == 0) { ok = batch_long(v, 1, 1024, &x); s.threads = (int)x; }
+        else if (strcmp(a, "--attempts") == 0) { ok = batch_long(v, 1, 1L << 30, &x); s.attempts = (int)x; }
+        else if (strcmp(a, "--seed") == 0) ok = batch_seed(v, &s.seed);
+        else if (strcmp(a, "--max-keys") == 0) { ok = batch_long(v, 1, 1L << 16, &x); s.max_keys = (int)x; }
+        else if (strcmp(a, "--calib") == 0) s.calib_path = v;
+        else if (strcmp(a, "--deadline-ms") == 0) { ok = batch_long(v, 0, 86400000L, &x); s.deadline_ms = (int)x; }
+        else if (strcmp(a, "--strength") == 0 && strcmp(v, "basic") == 0) s.strength = SOLVER_BASIC;
+        else if (strcmp(a, "--strength") == 0 && strcmp(v, "subset") == 0) s.strength = SOLVER_SUBSET;
+        else { svc_usage(argv[0]); return 2; }
+        if (!ok) {
+            fprintf(stderr, "Неверное значение %s для %s\n", v, a);
+            svc_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (s.threads < 1) s.threads = 1; /* на одноядерной машине пополняет один поток */
+#ifdef _WIN32
+    if (socket_path) { fprintf(stderr, "Unix-сокет недоступен в Windows: используйте stdin\n"); return 2; }
+#endif
+
+    s.keys = (SvcKey*)calloc((size_t)s.max_keys, sizeof(SvcKey));
+    s.workers = (SvcWorker*)calloc((size_t)s.threads, sizeof(SvcWorker));
+    s.calib = s.calib_path ? calib_load(s.calib_path) : NULL;
+    if (!s.keys || !s.workers || (s.calib_path && !s.calib)) {
+        free(s.keys);
+        free(s.workers);
+        calib_free(s.calib);
+        fprintf(stderr, "Ошибка выделения памяти\n");
+        return 1;
+    }
+    mt_mutex_init(&s.lock);
+    mt_cond_init(&s.wake);
+    s.t_start = mt_now_ns();
+
+    int started = 0;
+    for (; started < s.threads; ++started) {
+        s.workers[started].owner = &s;
+        if (!mt_thread_start(&s.workers[started].thread, svc_worker, &s.workers[started])) break;
+    }
+    fprintf(stderr, "Сервис: пул %d полей на конфигурацию, фоновых потоков %d\n", s.pool, started);
+
+    int rc = 0;
+#ifndef _WIN32
+    if (socket_path) rc = svc_listen(&s, socket_path);
+    else
+#endif
+        svc_session(&s, stdin, stdout);
+
+    mt_mutex_lock(&s.lock);
+    s.quit = true;
+    mt_atomic_store(&s.cancel, 1);
+    mt_cond_broadcast(&s.wake);
+    mt_mutex_unlock(&s.lock);
+    for (int t = 0; t < started; ++t) mt_thread_join(s.workers[t].thread);
+
+    svc_stats(&s, stderr);
+    if (s.calib && !calib_save(s.calib, s.calib_path)) {
+        fprintf(stderr, "Не удалось сохранить калибровку в %s\n", s.calib_path);
+        rc = 1;
+    }
+    calib_free(s.calib);
+    for (int i = 0; i < s.n_keys; ++i) free(s.keys[i].ring);
+    free(s.keys);
+    free(s.workers);
+#ifndef _WIN32
+    free(s.clients);
+#endif
+    mt_cond_destroy(&s.wake);
+    mt_mutex_destroy(&s.lock);
+    return rc;
+}
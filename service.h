@@ -0,0 +1,42 @@
+#ifndef MINES_SERVICE_H
+#define MINES_SERVICE_H
+
+/* -------------------------------------------------------------------
+   Режим сервиса: долго живущий процесс, который держит для каждой
+   конфигурации (rows, cols, density) пул заранее проверенных решаемых полей
+   и пополняет его фоновыми потоками. Запрос обслуживается из пула: поле
+   восстанавливается по 32-байтному дескриптору (fielddesc.h) за микросекунды,
+   а генерация с перебором попыток идёт заранее, вне запроса.
+
+   Протокол — строки текста (stdin/stdout или локальный Unix-сокет):
+     GET R C P      решаемое поле R x C с вероятностью мины P%:
+                    "OK hit|miss SEED START_R START_C", затем поле в формате
+                    write_field (строка "rows cols mines" и R строк)
+     DESC R C P     то же, но только дескриптор: "OK hit|miss HEX" (64 hex-цифры)
+     WARM R C P     начать заполнять пул конфигурации, не забирая поле: "OK"
+     STATS          счётчики: "OK ..." , строка "key ..." на конфигурацию, "END"
+     QUIT           закрыть сеанс
+     SHUTDOWN       остановить сервис
+   Ошибки: "ERR текст". Промах (пул пуст) решается в потоке запроса всеми ядрами,
+   а конфигурация ставится на фоновое пополнение.
+   ------------------------------------------------------------------- */
+
+/* run_service
+   - argv[1] == "--serve"; параметры:
+       --socket PATH              слушать Unix-сокет (иначе stdin/stdout)
+       --pool N                   полей в пуле одной конфигурации (по умолчанию 32)
+       --threads T                фоновых потоков пополнения (по умолчанию ядер - 1)
+       --attempts A               попыток на одно поле (по умолчанию 1000)
+       --strength basic|subset    уровень рассуждений солвера
+       --seed S                   зерно (по умолчанию — от времени)
+       --max-keys K               сколько конфигураций держать (по умолчанию 64)
+       --calib PATH               таблица калибровки (calib.h): бюджет попыток по
+                                  доле решаемых, безнадёжные конфигурации сразу
+                                  получают ERR; сохраняется при остановке
+       --deadline-ms D            срок генерации при промахе: не успели — "ERR timeout ..."
+                                  (пул конфигурации продолжает пополняться)
+   - Возвращает код завершения программы.
+*/
+int run_service(int argc, char** argv);
+
+#endif /* MINES_SERVICE_H */
@@ -0,0 +1,60 @@
+#include "stats.h"
+#include <string.h>
+
+/* Описание полей для печати: одна таблица на отчёт и JSON */
+#define STATS_COUNTERS(X) \
+    X(attempts) X(solvable) X(checks) X(openings) X(starts_skipped) X(solver_runs) \
+    X(cells_opened) X(rule_passes) X(work_items) X(subset_passes) X(subset_hits) \
+    X(repair_rounds) X(mines_moved)
+
+static const char* const STAT_PHASE_NAMES[STAT_PHASES] = { "place", "counts", "solve" };
+
+bool stats_enabled(void) {
+#ifdef FIELD_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void stats_clear(GenStats* s) {
+    if (s) memset(s, 0, sizeof *s);
+}
+
+void stats_merge(GenStats* dst, const GenStats* src) {
+    if (!dst || !src) return;
+#define X(name) dst->name += src->name;
+    STATS_COUNTERS(X)
+#undef X
+    for (int i = 0; i < STAT_PHASES; ++i) dst->ns[i] += src->ns[i];
+}
+
+void stats_print(const GenStats* s, FILE* out) {
+    if (!s || !out) return;
+    if (!stats_enabled()) {
+        fprintf(out, "Статистика не собрана: программа собрана без FIELD_STATS.\n");
+        return;
+    }
+    fprintf(out, "Статистика генерации:\n");
+#define X(name) fprintf(out, "  %-16s %llu\n", #name, (unsigned long long)s->name);
+    STATS_COUNTERS(X)
+#undef X
+    uint64_t total = 0;
+    for (int i = 0; i < STAT_PHASES; ++i) total += s->ns[i];
+    for (int i = 0; i < STAT_PHASES; ++i)
+        fprintf(out, "  время %-10s %.3f мс (%.1f%%)\n", STAT_PHASE_NAMES[i], s->ns[i] / 1e6,
+            total ? 100.0 * s->ns[i] / total : 0.0);
+    if (s->attempts)
+        fprintf(out, "  запусков солвера на попытку %.2f\n", (double)s->solver_runs / s->attempts);
+}
+
+void stats_write_json(const GenStats* s, FILE* out) {
+    if (!s || !out) return;
+    fprintf(out, "{\"enabled\": %s", stats_enabled() ? "true" : "false");
+#define X(name) fprintf(out, ", \"%s\": %llu", #name, (unsigned long long)s->name);
+    STATS_COUNTERS(X)
+#undef X
+    for (int i = 0; i < STAT_PHASES; ++i)
+        fprintf(out, ", \"ns_%s\": %llu", STAT_PHASE_NAMES[i], (unsigned long long)s->ns[i]);
+    fprintf(out, "}\n");
+}
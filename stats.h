@@ -0,0 +1,71 @@
+#ifndef MINES_STATS_H
+#define MINES_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* -------------------------------------------------------------------
+   Статистика генерации: счётчики и время по фазам.
+   Включается при сборке макросом FIELD_STATS (в CMake: -DFIELD_STATS=ON).
+   Без него макросы STAT_* ничего не делают и в горячем коде не остаётся
+   ни проверок, ни вызовов таймера. Структура и функции печати есть в обоих
+   вариантах, чтобы вызывающий код не менялся (поля тогда остаются нулями).
+   Сбор включается ещё и во время работы: передачей указателя на GenStats
+   (solver_ctx_set_stats, pargen_set_stats); NULL — ничего не считается.
+   ------------------------------------------------------------------- */
+
+/* Фазы, по которым распределяется время */
+typedef enum {
+    STAT_PLACE = 0,   /* расстановка мин (у генераторов с field_toggle_mine — вместе со счётчиками) */
+    STAT_COUNTS,      /* compute_counts после расстановки */
+    STAT_SOLVE,       /* проверка решаемости */
+    STAT_PHASES
+} StatPhase;
+
+typedef struct {
+    uint64_t attempts;           /* попыток генерации */
+    uint64_t solvable;           /* из них решаемых */
+    uint64_t checks;             /* вызовов check_solvability_ctx */
+    uint64_t openings;           /* нулевых областей, размеченных в check_solvability_ctx */
+    uint64_t starts_skipped;     /* стартов, пропущенных как уже покрытые */
+    uint64_t solver_runs;        /* запусков солвера (simulate_solver_ctx и внутренние) */
+    uint64_t cells_opened;       /* клеток, открытых всеми запусками */
+    uint64_t rule_passes;        /* проходов простых правил (solver_propagate) */
+    uint64_t work_items;         /* клеток, взятых из рабочего списка */
+    uint64_t subset_passes;      /* проходов второго уровня */
+    uint64_t subset_hits;        /* из них давших вывод */
+    uint64_t repair_rounds;      /* раундов починки (generate_repair) */
+    uint64_t mines_moved;        /* перенесённых или убранных починкой мин */
+    uint64_t ns[STAT_PHASES];    /* время по фазам, нс */
+} GenStats;
+
+#ifdef FIELD_STATS
+#include "mt.h"
+#define STAT_ADD(s, field, v) do { if (s) (s)->field += (uint64_t)(v); } while (0)
+#define STAT_TIME_BEGIN(t) uint64_t t = mt_now_ns()
+#define STAT_TIME_END(s, phase, t) do { if (s) (s)->ns[phase] += mt_now_ns() - (t); } while (0)
+#else
+#define STAT_ADD(s, field, v) ((void)0)
+#define STAT_TIME_BEGIN(t) ((void)0)
+#define STAT_TIME_END(s, phase, t) ((void)0)
+#endif
+
+/* stats_enabled
+   - Собрана ли программа с FIELD_STATS (иначе все счётчики остаются нулями).
+*/
+bool stats_enabled(void);
+
+/* stats_clear / stats_merge
+   - Обнуление и прибавление счётчиков src к dst (сбор по потокам).
+*/
+void stats_clear(GenStats* s);
+void stats_merge(GenStats* dst, const GenStats* src);
+
+/* stats_print / stats_write_json
+   - Краткий отчёт для человека и тот же набор полей одним JSON-объектом.
+*/
+void stats_print(const GenStats* s, FILE* out);
+void stats_write_json(const GenStats* s, FILE* out);
+
+#endif /* MINES_STATS_H */
@@ -0,0 +1,77 @@
+#include "tiled.h"
+#include "fielddesc.h"
+
+#define TILED_DEFAULT_ROWS 64
+
+/* Ширина поля mines в заголовке: хватает для любого 64-битного числа */
+#define TILED_MINES_WIDTH 20
+
+bool tiled_mine(uint64_t seed, uint32_t thr, long long r, int cols, int c) {
+    uint64_t cell = (uint64_t)r * (uint64_t)cols + (uint64_t)c;
+    uint64_t x = rng_derive(seed, cell >> 1);
+    uint32_t v = (cell & 1) ? (uint32_t)(x >> 32) : (uint32_t)x;
+    return v < thr;
+}
+
+/* Заполняет строку row полосы (может быть строкой ореола -1 или h) минами
+   строки r поля; за пределами поля строка пустая. Возвращает число мин. */
+static long long tiled_fill_row(Field* band, int row, long long r, long long rows,
+    uint64_t seed, uint32_t thr, bool all) {
+    unsigned char* m = band->is_mine + IDX(band, row, 0);
+    int C = band->cols;
+    if (r < 0 || r >= rows) {
+        memset(m, 0, (size_t)C);
+        return 0;
+    }
+    return fdesc_fill_row(m, r, C, seed, thr, all);
+}
+
+bool tiled_generate(const char* fname, long long rows, int cols, int percent, uint64_t seed,
+    int tile_rows, TiledResult* res) {
+    if (res) memset(res, 0, sizeof *res);
+    if (!fname || rows <= 0 || cols <= 0) return false;
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+    if (tile_rows <= 0) tile_rows = TILED_DEFAULT_ROWS;
+    if (tile_rows > rows) tile_rows = (int)rows;
+
+    /* полоса — обычное поле с рамкой: строки рамки сверху и снизу служат ореолом,
+       и compute_counts видит мины соседних полос без отдельного кода */
+    Field* band = field_create(tile_rows, cols);
+    if (!band) return false;
+    FILE* out = fopen(fname, "w");
+    if (!out) { field_free(band); return false; }
+    setvbuf(out, NULL, _IOFBF, 1 << 22);
+
+    bool ok = fprintf(out, "%lld %d %*d\n", rows, cols, TILED_MINES_WIDTH, 0) > 0;
+    uint32_t thr = rng_percent_threshold(percent);
+    bool all = (percent == 100);
+    long long mines = 0;
+    int tiles = 0;
+
+    for (long long r0 = 0; ok && r0 < rows; r0 += tile_rows) {
+        int h = rows - r0 < tile_rows ? (int)(rows - r0) : tile_rows;
+        band->rows = h; /* последняя полоса может быть короче; IDX от rows не зависит */
+        for (int i = 0; i < h; ++i) mines += tiled_fill_row(band, i, r0 + i, rows, seed, thr, all);
+        tiled_fill_row(band, -1, r0 - 1, rows, seed, thr, all);
+        tiled_fill_row(band, h, r0 + h, rows, seed, thr, all);
+
+        compute_counts(band);
+        ok = write_field_rows(band, out);
+        ++tiles;
+    }
+    band->rows = tile_rows;
+
+    /* заголовок той же длины: теперь с настоящим числом мин */
+    if (ok) ok = fflush(out) == 0 && fseek(out, 0, SEEK_SET) == 0
+        && fprintf(out, "%lld %d %*lld\n", rows, cols, TILED_MINES_WIDTH, mines) > 0;
+    if (fclose(out) != 0) ok = false;
+
+    if (res) {
+        res->mines = mines;
+        res->tiles = tiles;
+        res->peak_bytes = 2 * ((size_t)tile_rows + 2) * ((size_t)cols + 2);
+    }
+    field_free(band);
+    return ok;
+}
@@ -0,0 +1,43 @@
+#ifndef MINES_TILED_H
+#define MINES_TILED_H
+
+#include "field.h"
+#include <stdint.h>
+
+/* -------------------------------------------------------------------
+   Потоковая генерация полей, которые не помещаются в память.
+   Поле строится полосами по tile_rows строк и сразу пишется в файл в формате
+   save_field_to_file. В памяти одновременно только одна полоса и две строки
+   ореола (соседние строки предыдущей и следующей полосы).
+   Мина в клетке (r,c) определяется только seed и номером клетки r*cols + c
+   (RNG на счётчике: rng_derive(seed, номер / 2), по 32 бита на клетку), поэтому
+   строки ореола не хранятся, а вычисляются заново, и любую полосу можно
+   построить независимо от остальных. Это та же расстановка, что у дескриптора
+   поля (fielddesc.h) в режиме FDESC_PERCENT без первого клика.
+   Число строк 64-битное; ширина поля ограничена int.
+   ------------------------------------------------------------------- */
+
+/* Итог потоковой генерации */
+typedef struct {
+    long long mines;        /* всего мин */
+    int tiles;              /* записано полос */
+    size_t peak_bytes;      /* память под полосу (не зависит от числа строк) */
+} TiledResult;
+
+/* tiled_mine
+   - Есть ли мина в клетке (r,c) поля шириной cols при зерне seed и пороге thr
+     (rng_percent_threshold). Одна и та же для всех полос.
+*/
+bool tiled_mine(uint64_t seed, uint32_t thr, long long r, int cols, int c);
+
+/* tiled_generate
+   - Пишет в fname поле rows x cols с вероятностью мины percent.
+   - Заголовок "rows cols mines" пишется с полем mines фиксированной ширины и
+     дописывается в конце, когда число мин известно.
+   - tile_rows <= 0 — по умолчанию (64 строки).
+   - Возвращает false при ошибке выделения памяти или записи.
+*/
+bool tiled_generate(const char* fname, long long rows, int cols, int percent, uint64_t seed,
+    int tile_rows, TiledResult* res);
+
+#endif /* MINES_TILED_H */